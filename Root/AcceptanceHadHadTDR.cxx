@@ -19,11 +19,40 @@
 #include "TrigTauEmulation/MsgStream.h"
 #include "TriggerValidation/Utils.h"
 
+#include <sstream>
+#include <type_traits>
+
+// deep copy of a selection view, recorded in the store with its aux container
+template <typename CONTAINER>
+EL::StatusCode recordCopy(xAOD::TStore* store, const ConstDataVector<CONTAINER>& view, const std::string& name) {
+    typedef typename std::remove_const<typename std::remove_pointer<typename CONTAINER::value_type>::type>::type object_t;
+
+    CONTAINER* copy = new CONTAINER();
+    xAOD::AuxContainerBase* copy_aux = new xAOD::AuxContainerBase();
+    copy->setStore(copy_aux);
+    for (const auto obj : view) {
+        object_t* new_obj = new object_t();
+        new_obj->makePrivateStore(*obj);
+        copy->push_back(new_obj);
+    }
+
+    EL_RETURN_CHECK("recordCopy", store->record(copy, name));
+    EL_RETURN_CHECK("recordCopy", store->record(copy_aux, name + "Aux."));
+    return EL::StatusCode::SUCCESS;
+}
+
+// retrieve an input container and count the read
+template <typename T>
+EL::StatusCode retrieveCounted(xAOD::TEvent* event, const T*& obj, const std::string& key, TH1F* h_reads) {
+    EL_RETURN_CHECK("retrieveCounted", event->retrieve(obj, key));
+    h_reads->Fill(key.c_str(), 1);
+    return EL::StatusCode::SUCCESS;
+}
+
 // this is needed to distribute the algorithm to the workers
 ClassImp(AcceptanceHadHadTDR)
 
-    AcceptanceHadHadTDR::AcceptanceHadHadTDR()
-    : m_book("book") {}
+    AcceptanceHadHadTDR::AcceptanceHadHadTDR() : m_tau_matcher(0.4), record_selections(false), fill_buffer_size(1000) {}
 
 EL::StatusCode AcceptanceHadHadTDR::setupJob(EL::Job& job) {
     job.useXAOD();
@@ -32,52 +61,133 @@ EL::StatusCode AcceptanceHadHadTDR::setupJob(EL::Job& job) {
 }
 
 EL::StatusCode AcceptanceHadHadTDR::histInitialize() {
-    hists["cutflow"] = new TH1F("cutflow", "cutflow", 10, 0, 10);
-    hists["cutflow"]->GetXaxis()->SetBinLabel(1, "init");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(2, "taus");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(3, "taus_pt");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(4, "dr_tau_tau");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(5, "truth_matching");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(6, "jets");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(7, "jets_pt");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(8, "deta_jets");
-    hists["cutflow"]->GetXaxis()->SetBinLabel(9, "l1taus");
-
-    hists["l1_symmetric"] = new TH1F("l1_symmetric", "l1_symmetric", l1_nsteps, l1_min, l1_min + l1_step * l1_nsteps);
-    hists["off_symmetric"] = new TH1F("off_symmetric", "off_symmetric", off_nsteps, tau1_pt, tau1_pt + off_step * off_nsteps);
-
-    map_l1 = new TH2F("l1_asymmetric", "l1_asymmetric", l1_nsteps, l1_min, l1_min + l1_step * l1_nsteps, l1_nsteps, l1_min,
-                      l1_min + l1_step * l1_nsteps);
-
-    for (int i = 0; i < l1_nsteps; i++) {
-        int thresh = (int)(l1_min / 1000 + l1_step * i / 1000);
-        hists["l1_symmetric"]->GetXaxis()->SetBinLabel(i + 1, Form("2TAU%d", thresh));
-        map_l1->GetXaxis()->SetBinLabel(i + 1, Form("TAU%d", thresh));
-        map_l1->GetYaxis()->SetBinLabel(i + 1, Form("TAU%d", thresh));
+    // the default configuration first, then the additional ones
+    m_configs.clear();
+    m_configs.push_back(makeConfig(""));
+    for (const auto& spec : cut_configs) {
+        std::istringstream tokens(spec);
+        std::string name;
+        std::string settings;
+        tokens >> name;
+        std::getline(tokens, settings);
+
+        CutConfig config = makeConfig(name);
+        if (name.empty() or not config.configure(settings)) {
+            Error("histInitialize", "Invalid cut configuration: \"%s\"", spec.c_str());
+            return EL::StatusCode::FAILURE;
+        }
+        m_configs.push_back(config);
     }
 
-    map_off = new TH2F("off_asymmetric", "off_asymmetric", off_nsteps, tau2_pt, tau2_pt + off_step * off_nsteps, off_nsteps,
-                       tau1_pt, tau1_pt + off_step * off_nsteps);
+    for (auto& config : m_configs) bookConfig(config);
 
-    for (int i = 0; i < off_nsteps; i++) {
-        float thresh_1 = tau1_pt / 1000. + off_step * i / 1000.;
-        float thresh_2 = tau2_pt / 1000. + off_step * i / 1000.;
-        hists["off_symmetric"]->GetXaxis()->SetBinLabel(i + 1, Form("2tau%d", (int)thresh_1));
-        map_off->GetXaxis()->SetBinLabel(i + 1, Form("tau%d", (int)thresh_1));
-        map_off->GetYaxis()->SetBinLabel(i + 1, Form("tau%d", (int)thresh_2));
-    }
+    hists["cutflow"] = m_configs[0].cutflow;
+    hists["l1_symmetric"] = m_configs[0].l1_symmetric;
+    hists["off_symmetric"] = m_configs[0].off_symmetric;
+    map_l1 = m_configs[0].map_l1;
+    map_off = m_configs[0].map_off;
+    map_l1taus = m_configs[0].map_l1taus;
 
-    m_book.book();
-    m_book.record(wk());
+    h_container_reads = new TH1F("container_reads", "container_reads", 4, 0, 4);
+    h_container_reads->GetXaxis()->SetBinLabel(1, "events");
+    h_container_reads->GetXaxis()->SetBinLabel(2, "TauJets");
+    h_container_reads->GetXaxis()->SetBinLabel(3, "AntiKt4LCTopoJets");
+    h_container_reads->GetXaxis()->SetBinLabel(4, "LVL1EmTauRoIs");
+    wk()->addOutput(h_container_reads);
 
-    map_l1taus = new TH2F("map_l1taus", "map_l1taus", 100, 0, 100000, 100, 0, 100000);
-    wk()->addOutput(map_l1taus);
-    wk()->addOutput(map_l1);
-    wk()->addOutput(map_off);
+    return EL::StatusCode::SUCCESS;
+}
 
-    for (const auto it : hists) wk()->addOutput(it.second);
+CutConfig AcceptanceHadHadTDR::makeConfig(const std::string& name) const {
+    CutConfig config(name);
+    config.tau1_pt = tau1_pt;
+    config.tau2_pt = tau2_pt;
+    config.min_dr_tautau = min_dr_tautau;
+    config.max_dr_tautau = max_dr_tautau;
+    config.n_jets = n_jets;
+    config.jet1_pt = jet1_pt;
+    config.jet2_pt = jet2_pt;
+    config.delta_eta_jj = delta_eta_jj;
+    return config;
+}
 
-    return EL::StatusCode::SUCCESS;
+void AcceptanceHadHadTDR::bookConfig(CutConfig& config) {
+    const std::string prefix = config.prefix();
+
+    config.cutflow = new TH1F((prefix + "cutflow").c_str(), "cutflow", 10, 0, 10);
+    config.cutflow->GetXaxis()->SetBinLabel(1, "init");
+    config.cutflow->GetXaxis()->SetBinLabel(2, "taus");
+    config.cutflow->GetXaxis()->SetBinLabel(3, "taus_pt");
+    config.cutflow->GetXaxis()->SetBinLabel(4, "dr_tau_tau");
+    config.cutflow->GetXaxis()->SetBinLabel(5, "truth_matching");
+    config.cutflow->GetXaxis()->SetBinLabel(6, "jets");
+    config.cutflow->GetXaxis()->SetBinLabel(7, "jets_pt");
+    config.cutflow->GetXaxis()->SetBinLabel(8, "deta_jets");
+    config.cutflow->GetXaxis()->SetBinLabel(9, "l1taus");
+
+    config.l1_symmetric = new TH1F((prefix + "l1_symmetric").c_str(), "l1_symmetric", l1_nsteps, l1_min,
+                                   l1_min + l1_step * l1_nsteps);
+    config.off_symmetric = new TH1F((prefix + "off_symmetric").c_str(), "off_symmetric", off_nsteps, config.tau1_pt,
+                                    config.tau1_pt + off_step * off_nsteps);
+
+    config.map_l1 = new TH2F((prefix + "l1_asymmetric").c_str(), "l1_asymmetric", l1_nsteps, l1_min,
+                             l1_min + l1_step * l1_nsteps, l1_nsteps, l1_min, l1_min + l1_step * l1_nsteps);
+
+    std::vector<double> l1_thresholds;
+    std::vector<std::string> l1_sym_labels;
+    std::vector<std::string> l1_labels;
+    for (int i = 0; i < l1_nsteps; i++) {
+        int thresh = (int)(l1_min / 1000 + l1_step * i / 1000);
+        config.l1_symmetric->GetXaxis()->SetBinLabel(i + 1, Form("2TAU%d", thresh));
+        config.map_l1->GetXaxis()->SetBinLabel(i + 1, Form("TAU%d", thresh));
+        config.map_l1->GetYaxis()->SetBinLabel(i + 1, Form("TAU%d", thresh));
+
+        l1_thresholds.push_back(1000 * thresh);
+        l1_sym_labels.push_back(Form("2TAU%d", thresh));
+        l1_labels.push_back(Form("TAU%d", thresh));
+    }
+    config.l1_scan.setup(l1_thresholds, l1_thresholds, config.l1_symmetric, l1_sym_labels, config.map_l1, l1_labels,
+                         l1_labels);
+
+    config.map_off = new TH2F((prefix + "off_asymmetric").c_str(), "off_asymmetric", off_nsteps, config.tau2_pt,
+                              config.tau2_pt + off_step * off_nsteps, off_nsteps, config.tau1_pt,
+                              config.tau1_pt + off_step * off_nsteps);
+
+    std::vector<double> off_lead_thresholds;
+    std::vector<double> off_sublead_thresholds;
+    std::vector<std::string> off_sym_labels;
+    std::vector<std::string> off_lead_labels;
+    std::vector<std::string> off_sublead_labels;
+    for (int i = 0; i < off_nsteps; i++) {
+        float thresh_1 = config.tau1_pt / 1000. + off_step * i / 1000.;
+        float thresh_2 = config.tau2_pt / 1000. + off_step * i / 1000.;
+        config.off_symmetric->GetXaxis()->SetBinLabel(i + 1, Form("2tau%d", (int)thresh_1));
+        config.map_off->GetXaxis()->SetBinLabel(i + 1, Form("tau%d", (int)thresh_1));
+        config.map_off->GetYaxis()->SetBinLabel(i + 1, Form("tau%d", (int)thresh_2));
+
+        off_lead_thresholds.push_back(1000. * thresh_1);
+        off_sublead_thresholds.push_back(1000. * thresh_2);
+        off_sym_labels.push_back(Form("2tau%d", (int)thresh_2));
+        off_lead_labels.push_back(Form("tau%d", (int)thresh_1));
+        off_sublead_labels.push_back(Form("tau%d", (int)thresh_2));
+    }
+    config.off_scan.setup(off_lead_thresholds, off_sublead_thresholds, config.off_symmetric, off_sym_labels, config.map_off,
+                          off_lead_labels, off_sublead_labels);
+
+    config.book.book();
+    config.book.setBufferSize(fill_buffer_size);
+    config.book.record(wk());
+
+    config.map_l1taus = new TH2F((prefix + "map_l1taus").c_str(), "map_l1taus", 100, 0, 100000, 100, 0, 100000);
+    config.map_l1taus_buffer.setHist(config.map_l1taus);
+    config.map_l1taus_buffer.setSize(fill_buffer_size);
+    wk()->addOutput(config.map_l1taus);
+    wk()->addOutput(config.map_l1);
+    wk()->addOutput(config.map_off);
+
+    wk()->addOutput(config.cutflow);
+    wk()->addOutput(config.l1_symmetric);
+    wk()->addOutput(config.off_symmetric);
 }
 
 EL::StatusCode AcceptanceHadHadTDR::fileExecute() {
@@ -134,158 +244,130 @@ EL::StatusCode AcceptanceHadHadTDR::execute() {
     MY_MSG_DEBUG("execute next event");
     if ((wk()->treeEntry() % 200) == 0) MY_MSG_INFO("Read event number " << wk()->treeEntry() << " / " << event->getEntries());
 
-    hists["cutflow"]->Fill("init", 1);
+    // recycle the selection views of the previous event
+    m_arena.reset();
 
-    // retrieve the EDM objects
-    const xAOD::EventInfo* ei = 0;
-    EL_RETURN_CHECK("execute", event->retrieve(ei, "EventInfo"));
-
-    const xAOD::EmTauRoIContainer* l1taus = 0;
-    EL_RETURN_CHECK("execute", event->retrieve(l1taus, "LVL1EmTauRoIs"));
+    for (auto& config : m_configs) config.cutflow->Fill("init", 1);
+    h_container_reads->Fill("events", 1);
 
+    // the containers are retrieved in the order of the cuts, so that the
+    // jets, the L1 RoIs and the truth are only read for events passing the
+    // tau selection
     const xAOD::TauJetContainer* taus = 0;
-    EL_RETURN_CHECK("execute", event->retrieve(taus, "TauJets"));
-
-    const xAOD::JetContainer* jets = 0;
-    EL_RETURN_CHECK("execute", event->retrieve(jets, "AntiKt4LCTopoJets"));
-
-    // event initialization of the tools (if needed)
-    EL_RETURN_CHECK("execute", m_t2mt->initializeEvent());
-
-    xAOD::TauJetContainer* selected_taus = new xAOD::TauJetContainer();
-    xAOD::AuxContainerBase* selected_taus_aux = new xAOD::AuxContainerBase();
-    selected_taus->setStore(selected_taus_aux);
+    EL_RETURN_CHECK("execute", retrieveCounted(event, taus, "TauJets", h_container_reads));
 
+    ConstDataVector<xAOD::TauJetContainer>* selected_taus = m_arena.view<xAOD::TauJetContainer>();
     select_taus(selected_taus, taus);
 
     if (selected_taus->size() < 2) return EL::StatusCode::SUCCESS;
 
-    hists["cutflow"]->Fill("taus", 1);
-
-    xAOD::TauJet* tau1 = selected_taus->at(0);
-    xAOD::TauJet* tau2 = selected_taus->at(1);
-
-    // Leading tau pt cut
-    if (tau1->pt() < tau1_pt) return EL::StatusCode::SUCCESS;
+    // only the two leading objects of each selection are used
+    Utils::leading(*selected_taus, 2, Utils::comparePt, m_lead_taus);
+    const xAOD::TauJet* tau1 = m_lead_taus[0];
+    const xAOD::TauJet* tau2 = m_lead_taus[1];
+    const double dr_tautau = tau1->p4().DeltaR(tau2->p4());
 
-    // Subleading tau pt cut
-    if (tau2->pt() < tau2_pt) return EL::StatusCode::SUCCESS;
+    // tau cuts of every configuration, the rest of the event is only
+    // decoded once for all the configurations that pass them
+    m_passed.clear();
+    for (auto& config : m_configs) {
+        config.cutflow->Fill("taus", 1);
 
-    hists["cutflow"]->Fill("taus_pt", 1);
+        // Leading and subleading tau pt cuts
+        if (tau1->pt() < config.tau1_pt or tau2->pt() < config.tau2_pt) continue;
+        config.cutflow->Fill("taus_pt", 1);
 
-    // DR(TAU, TAU) cut
-    if (tau1->p4().DeltaR(tau2->p4()) < min_dr_tautau) return EL::StatusCode::SUCCESS;
+        // DR(TAU, TAU) cut
+        if (dr_tautau < config.min_dr_tautau or dr_tautau > config.max_dr_tautau) continue;
+        config.cutflow->Fill("dr_tau_tau", 1);
 
-    if (tau1->p4().DeltaR(tau2->p4()) > max_dr_tautau) return EL::StatusCode::SUCCESS;
+        m_passed.push_back(&config);
+    }
+    if (m_passed.empty()) return EL::StatusCode::SUCCESS;
 
-    hists["cutflow"]->Fill("dr_tau_tau", 1);
+    // event initialization of the tools (if needed)
+    EL_RETURN_CHECK("execute", m_t2mt->initializeEvent());
 
     const xAOD::TruthParticle* truth_tau1 = m_t2mt->getTruth(*tau1);
     const xAOD::TruthParticle* truth_tau2 = m_t2mt->getTruth(*tau2);
     if (truth_tau1 == NULL or truth_tau2 == NULL) return EL::StatusCode::SUCCESS;
 
-    hists["cutflow"]->Fill("truth_matching", 1);
+    for (auto config : m_passed) config->cutflow->Fill("truth_matching", 1);
 
-    // MY_MSG_INFO("DR(tau1, tau2) = " << tau1->p4().DeltaR(tau2->p4()));
+    const xAOD::JetContainer* jets = 0;
+    EL_RETURN_CHECK("execute", retrieveCounted(event, jets, "AntiKt4LCTopoJets", h_container_reads));
 
-    xAOD::JetContainer* selected_jets = new xAOD::JetContainer();
-    xAOD::AuxContainerBase* selected_jets_aux = new xAOD::AuxContainerBase();
-    selected_jets->setStore(selected_jets_aux);
+    ConstDataVector<xAOD::JetContainer>* selected_jets = m_arena.view<xAOD::JetContainer>();
     select_jets(selected_jets, jets, tau1, tau2);
 
-    // MY_MSG_INFO("Number of jets = " << selected_jets->size());
-    if ((int)selected_jets->size() < n_jets) return EL::StatusCode::SUCCESS;
-
-    hists["cutflow"]->Fill("jets", 1);
-
-    xAOD::Jet* jet1 = nullptr;
-    xAOD::Jet* jet2 = nullptr;
-
-    if ((int)selected_jets->size() > 0) {
-        jet1 = selected_jets->at(0);
-
-        if (jet1->pt() < jet1_pt) return EL::StatusCode::SUCCESS;
-
-        if ((int)selected_jets->size() > 1) {
-            jet2 = selected_jets->at(1);
-
-            if (jet2->pt() < jet2_pt) return EL::StatusCode::SUCCESS;
-            hists["cutflow"]->Fill("jets_pt", 1);
-
-            double delta_eta = fabs(jet1->eta() - jet2->eta());
-            if (delta_eta < delta_eta_jj) return EL::StatusCode::SUCCESS;
-            hists["cutflow"]->Fill("deta_jets", 1);
-
-        } else {
-            hists["cutflow"]->Fill("jets_pt", 1);
+    Utils::leading(*selected_jets, 2, Utils::comparePt, m_lead_jets);
+    const xAOD::Jet* jet1 = m_lead_jets.size() > 0 ? m_lead_jets[0] : nullptr;
+    const xAOD::Jet* jet2 = m_lead_jets.size() > 1 ? m_lead_jets[1] : nullptr;
+    const double delta_eta = jet2 != nullptr ? fabs(jet1->eta() - jet2->eta()) : 0.;
+
+    // jet cuts, only keep the configurations passing them
+    unsigned int n_passed = 0;
+    for (auto config : m_passed) {
+        if ((int)selected_jets->size() < config->n_jets) continue;
+        config->cutflow->Fill("jets", 1);
+
+        if (jet1 != nullptr) {
+            if (jet1->pt() < config->jet1_pt) continue;
+
+            if (jet2 != nullptr) {
+                if (jet2->pt() < config->jet2_pt) continue;
+                config->cutflow->Fill("jets_pt", 1);
+
+                if (delta_eta < config->delta_eta_jj) continue;
+                config->cutflow->Fill("deta_jets", 1);
+            } else {
+                config->cutflow->Fill("jets_pt", 1);
+            }
         }
-
-        // for (auto trig: triggers) {
-        //   MY_MSG_INFO(trig);
-        //   bool pass = m_trigDecisionTool->isPassed(trig);
-        //   m_curves_tools_final[trig]->fill_hadhad(pass, tau1, tau2, selected_jets->at(0));
-        // }
+        m_passed[n_passed++] = config;
     }
+    m_passed.resize(n_passed);
+    if (m_passed.empty()) return EL::StatusCode::SUCCESS;
 
-    xAOD::EmTauRoIContainer* selected_l1taus = new xAOD::EmTauRoIContainer();
-    xAOD::AuxContainerBase* selected_l1taus_aux = new xAOD::AuxContainerBase();
-    selected_l1taus->setStore(selected_l1taus_aux);
-
-    for (const auto l1tau : *l1taus) {
-        if (l1tau->roiType() != xAOD::EmTauRoI::TauRoIWord) continue;
-        xAOD::EmTauRoI* new_l1tau = new xAOD::EmTauRoI();
-        new_l1tau->makePrivateStore(*l1tau);
-        selected_l1taus->push_back(new_l1tau);
-    }
+    const xAOD::EmTauRoIContainer* l1taus = 0;
+    EL_RETURN_CHECK("execute", retrieveCounted(event, l1taus, "LVL1EmTauRoIs", h_container_reads));
 
-    selected_l1taus->sort(Utils::compareTauClus);
+    ConstDataVector<xAOD::EmTauRoIContainer>* selected_l1taus = m_arena.view<xAOD::EmTauRoIContainer>();
+    select_l1taus(selected_l1taus, l1taus);
 
     if (selected_l1taus->size() < 2) return EL::StatusCode::SUCCESS;
 
-    hists["cutflow"]->Fill("l1taus", 1);
+    for (auto config : m_passed) config->cutflow->Fill("l1taus", 1);
 
-    xAOD::EmTauRoI* l1tau1 = selected_l1taus->at(0);
-    xAOD::EmTauRoI* l1tau2 = selected_l1taus->at(1);
+    Utils::leading(*selected_l1taus, 2, Utils::compareTauClus, m_lead_l1taus);
+    const xAOD::EmTauRoI* l1tau1 = m_lead_l1taus[0];
+    const xAOD::EmTauRoI* l1tau2 = m_lead_l1taus[1];
 
     MY_MSG_DEBUG("Read event number " << wk()->treeEntry() << " / " << event->getEntries());
 
-    for (int i = 0; i < l1_nsteps; i++) {
-        int thresh_sublead = (int)(l1_min / 1000 + l1_step * i / 1000);
-        if (l1tau1->tauClus() >= 1000 * thresh_sublead and l1tau2->tauClus() >= 1000 * thresh_sublead)
-            hists["l1_symmetric"]->Fill(Form("2TAU%d", thresh_sublead), 1);
-        for (int j = i; j < l1_nsteps; j++) {
-            int thresh_lead = (int)(l1_min / 1000 + l1_step * j / 1000);
-            if (l1tau2->tauClus() >= 1000 * thresh_sublead and l1tau1->tauClus() >= 1000 * thresh_lead)
-                map_l1->Fill(Form("TAU%d", thresh_lead), Form("TAU%d", thresh_sublead), 1);
-        }
-    }
-
-    for (int i = 0; i < off_nsteps; i++) {
-        float thresh_sublead = tau2_pt / 1000. + off_step * i / 1000.;
-        if (tau1->pt() >= 1000. * thresh_sublead and tau2->pt() >= 1000. * thresh_sublead)
-            hists["off_symmetric"]->Fill(Form("2tau%d", (int)thresh_sublead), 1);
-        for (int j = i; j < off_nsteps; j++) {
-            float thresh_lead = tau1_pt / 1000. + off_step * j / 1000.;
-            if (tau2->pt() >= 1000. * thresh_sublead and tau1->pt() >= 1000. * thresh_lead)
-                map_off->Fill(Form("tau%d", (int)thresh_lead), Form("tau%d", (int)thresh_sublead), 1);
-        }
-    }
-
     MY_MSG_DEBUG("Fill kinematics histograms:");
-    m_book.fill_tau(tau1, tau2);
-    m_book.fill_jet(jet1, jet2);
-    m_book.fill_truth(truth_tau1, truth_tau2);
+    for (auto config : m_passed) {
+        config->l1_scan.fill(l1tau1->tauClus(), l1tau2->tauClus());
+        config->off_scan.fill(tau1->pt(), tau2->pt());
 
-    map_l1taus->Fill(l1tau1->tauClus(), l1tau2->tauClus());
+        config->book.fill_tau(tau1, tau2);
+        config->book.fill_jet(jet1, jet2);
+        config->book.fill_truth(truth_tau1, truth_tau2);
 
-    EL_RETURN_CHECK("execute", store->record(selected_jets, "SelectedJets"));
-    EL_RETURN_CHECK("execute", store->record(selected_jets_aux, "SelectedJetsAux."));
+        config->map_l1taus_buffer.fill(l1tau1->tauClus(), l1tau2->tauClus(), 1.0);
+    }
 
-    EL_RETURN_CHECK("execute", store->record(selected_taus, "SelectedTaus"));
-    EL_RETURN_CHECK("execute", store->record(selected_taus_aux, "SelectedTausAux."));
+    // the copies are only made when someone downstream needs them
+    if (record_selections) {
+        // sorted as they used to be
+        selected_jets->sort(Utils::comparePt);
+        selected_taus->sort(Utils::comparePt);
+        selected_l1taus->sort(Utils::compareTauClus);
 
-    EL_RETURN_CHECK("execute", store->record(selected_l1taus, "SelectedL1Taus"));
-    EL_RETURN_CHECK("execute", store->record(selected_l1taus_aux, "SelectedL1TausAux."));
+        EL_RETURN_CHECK("execute", recordCopy(store, *selected_jets, "SelectedJets"));
+        EL_RETURN_CHECK("execute", recordCopy(store, *selected_taus, "SelectedTaus"));
+        EL_RETURN_CHECK("execute", recordCopy(store, *selected_l1taus, "SelectedL1Taus"));
+    }
 
     return EL::StatusCode::SUCCESS;
 }
@@ -327,90 +409,72 @@ EL::StatusCode AcceptanceHadHadTDR::histFinalize() {
     // outputs have been merged.  This is different from finalize() in
     // that it gets called on all worker nodes regardless of whether
     // they processed input events.
+
+    // the threshold scans only count events and the other fills are
+    // buffered, fill the histograms now
+    for (auto& config : m_configs) {
+        config.l1_scan.finalize();
+        config.off_scan.finalize();
+        config.book.flush();
+        config.map_l1taus_buffer.flush();
+    }
+
     return EL::StatusCode::SUCCESS;
 }
 
-EL::StatusCode AcceptanceHadHadTDR::select_taus(xAOD::TauJetContainer* selected_taus, const xAOD::TauJetContainer* taus)
+EL::StatusCode AcceptanceHadHadTDR::select_taus(ConstDataVector<xAOD::TauJetContainer>* selected_taus,
+                                                const xAOD::TauJetContainer* taus)
 
 {
-    for (const auto tau : *taus) {
-        // pt cut
-        if (tau->pt() < 20000.) {
-            MY_MSG_DEBUG("Reject tau " << tau->index() << " with pt = " << tau->pt());
-            continue;
-        }
-
-        // eta cut
-        if (fabs(tau->eta()) > 2.5) {
-            MY_MSG_DEBUG("Reject tau " << tau->index() << " with eta = " << tau->eta());
-            continue;
+    // pt > 20 GeV, |eta| < 2.5 outside of the crack, 1 or 3 tracks, medium ID
+    TauCuts cuts;
+    cuts.min_pt = 20000.;
+
+    m_tau_snapshot.fill(*taus);
+    m_tau_snapshot.select(cuts, m_mask);
+    for (unsigned int i = 0; i < m_mask.size(); i++) {
+        if (not m_mask[i]) {
+            MY_MSG_DEBUG("Reject tau " << taus->at(i)->index());
         }
-
-        if (fabs(tau->eta()) > 1.37 and fabs(tau->eta()) < 1.52) {
-            MY_MSG_DEBUG("Reject tau " << tau->index() << " with eta = " << tau->eta());
-            continue;
-        }
-
-        // 1 or 3 tracks
-        if (tau->nTracks() != 1 and tau->nTracks() != 3) {
-            MY_MSG_DEBUG("Reject tau " << tau->index() << " with nTracks = " << tau->nTracks());
-            continue;
-        }
-        // ID cut
-        if (not tau->isTau(xAOD::TauJetParameters::JetBDTSigMedium)) {
-            MY_MSG_DEBUG("Reject tau " << tau->index()
-                                       << " with medium ID = " << tau->isTau(xAOD::TauJetParameters::JetBDTSigMedium));
-            continue;
-        }
-        // selectDec(*tau) = true;
-        xAOD::TauJet* new_tau = new xAOD::TauJet();
-        new_tau->makePrivateStore(*tau);
-        selected_taus->push_back(new_tau);
     }
-
-    // sort by pt
-    selected_taus->sort(Utils::comparePt);
+    pushSelected(*taus, m_mask, selected_taus);
 
     return EL::StatusCode::SUCCESS;
 }
 
-EL::StatusCode AcceptanceHadHadTDR::select_jets(xAOD::JetContainer* selected_jets, const xAOD::JetContainer* jets,
+EL::StatusCode AcceptanceHadHadTDR::select_jets(ConstDataVector<xAOD::JetContainer>* selected_jets, const xAOD::JetContainer* jets,
                                                 const xAOD::TauJet* tau1, const xAOD::TauJet* tau2) {
-    for (const auto jet : *jets) {
-        // pt cut
-        if (jet->pt() < 30000.) continue;
+    m_tau_matcher.clear();
+    m_tau_matcher.add(tau1->eta(), tau1->phi());
+    m_tau_matcher.add(tau2->eta(), tau2->phi());
+
+    // pt and eta cuts
+    JetCuts cuts;
+    cuts.min_pt = 30000.;
+    cuts.max_eta = jet_eta;
 
-        // eta cut
-        if (fabs(jet->eta()) > jet_eta) continue;
+    m_jet_snapshot.fill(*jets);
+    m_jet_snapshot.select(cuts, m_mask);
 
-        // ORL with first tau
-        if (jet->p4().DeltaR(tau1->p4()) < 0.4) continue;
+    for (unsigned int i = 0; i < m_mask.size(); i++) {
+        if (not m_mask[i]) continue;
 
-        // ORL with second tau
-        if (jet->p4().DeltaR(tau2->p4()) < 0.4) continue;
+        // ORL with the two taus
+        const xAOD::Jet* jet = jets->at(i);
+        if (m_tau_matcher.match(jet)) continue;
 
-        xAOD::Jet* new_jet = new xAOD::Jet();
-        new_jet->makePrivateStore(*jet);
-        selected_jets->push_back(new_jet);
+        selected_jets->push_back(jet);
     }
-    // sort them by pT
-    selected_jets->sort(Utils::comparePt);
 
     return EL::StatusCode::SUCCESS;
 }
 
-EL::StatusCode AcceptanceHadHadTDR::select_l1taus(xAOD::EmTauRoIContainer* selected_l1taus,
+EL::StatusCode AcceptanceHadHadTDR::select_l1taus(ConstDataVector<xAOD::EmTauRoIContainer>* selected_l1taus,
                                                   const xAOD::EmTauRoIContainer* l1taus) {
     for (const auto l1tau : *l1taus) {
         if (l1tau->roiType() != xAOD::EmTauRoI::TauRoIWord) continue;
-
-        xAOD::EmTauRoI* new_l1tau = new xAOD::EmTauRoI();
-        new_l1tau->makePrivateStore(*l1tau);
-        selected_l1taus->push_back(new_l1tau);
+        selected_l1taus->push_back(l1tau);
     }
 
-    // sort by tauClus
-    selected_l1taus->sort(Utils::compareTauClus);
-
     return EL::StatusCode::SUCCESS;
 }
@@ -0,0 +1,59 @@
+#include "TriggerValidation/CutConfig.h"
+
+#include <sstream>
+
+CutConfig::CutConfig(const std::string& name)
+    : name(name),
+      tau1_pt(0),
+      tau2_pt(0),
+      min_dr_tautau(0),
+      max_dr_tautau(0),
+      n_jets(0),
+      jet1_pt(0),
+      jet2_pt(0),
+      delta_eta_jj(0),
+      cutflow(NULL),
+      l1_symmetric(NULL),
+      off_symmetric(NULL),
+      map_l1(NULL),
+      map_off(NULL),
+      map_l1taus(NULL),
+      book(prefix() + "book") {}
+
+bool CutConfig::configure(const std::string& settings) {
+    std::istringstream tokens(settings);
+    std::string token;
+    while (tokens >> token) {
+        size_t pos = token.find('=');
+        if (pos == std::string::npos) return false;
+
+        const std::string key = token.substr(0, pos);
+        std::istringstream value(token.substr(pos + 1));
+
+        if (key == "tau1_pt")
+            value >> tau1_pt;
+        else if (key == "tau2_pt")
+            value >> tau2_pt;
+        else if (key == "min_dr_tautau")
+            value >> min_dr_tautau;
+        else if (key == "max_dr_tautau")
+            value >> max_dr_tautau;
+        else if (key == "n_jets")
+            value >> n_jets;
+        else if (key == "jet1_pt")
+            value >> jet1_pt;
+        else if (key == "jet2_pt")
+            value >> jet2_pt;
+        else if (key == "delta_eta_jj")
+            value >> delta_eta_jj;
+        else
+            return false;
+
+        if (value.fail()) return false;
+    }
+    return true;
+}
+
+std::string CutConfig::prefix() const {
+    return name.empty() ? "" : name + "/";
+}
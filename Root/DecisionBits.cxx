@@ -0,0 +1,65 @@
+#include "TriggerValidation/DecisionBits.h"
+
+#include "TList.h"
+#include "TObjString.h"
+#include "TString.h"
+
+DecisionBits::DecisionBits() : m_run(0), m_lumiblock(0), m_event(0), m_tree(nullptr) {}
+
+void DecisionBits::book(TDirectory* dir, const std::vector<std::string>& chains) {
+    m_chains = chains;
+    const unsigned int nwords = (m_chains.size() + 63) / 64;
+    m_tdt.assign(nwords, 0);
+    m_emulation.assign(nwords, 0);
+
+    m_tree = new TTree("decisions", "TDT and emulation decisions, one bit per chain");
+    m_tree->SetDirectory(dir);
+    for (auto& chain : m_chains) m_tree->GetUserInfo()->Add(new TObjString(chain.c_str()));
+
+    m_tree->Branch("run", &m_run, "run/i");
+    m_tree->Branch("lumiblock", &m_lumiblock, "lumiblock/i");
+    m_tree->Branch("event", &m_event, "event/l");
+    m_tree->Branch("tdt", m_tdt.data(), Form("tdt[%u]/l", nwords));
+    m_tree->Branch("emulation", m_emulation.data(), Form("emulation[%u]/l", nwords));
+}
+
+bool DecisionBits::attach(TTree* tree) {
+    m_tree = tree;
+
+    m_chains.clear();
+    TIter next(m_tree->GetUserInfo());
+    while (TObject* obj = next()) m_chains.push_back(obj->GetName());
+
+    const char* names[] = {"run", "lumiblock", "event", "tdt", "emulation"};
+    for (auto name : names) {
+        if (not m_tree->GetBranch(name)) return false;
+    }
+
+    const unsigned int nwords = (m_chains.size() + 63) / 64;
+    m_tdt.assign(nwords, 0);
+    m_emulation.assign(nwords, 0);
+
+    m_tree->SetBranchAddress("run", &m_run);
+    m_tree->SetBranchAddress("lumiblock", &m_lumiblock);
+    m_tree->SetBranchAddress("event", &m_event);
+    m_tree->SetBranchAddress("tdt", m_tdt.data());
+    m_tree->SetBranchAddress("emulation", m_emulation.data());
+    return true;
+}
+
+void DecisionBits::pack(const std::vector<char>& flags, std::vector<ULong64_t>& bits) {
+    for (auto& word : bits) word = 0;
+    for (unsigned int i = 0; i < flags.size(); i++) {
+        if (flags[i]) bits[i / 64] |= 1ULL << (i % 64);
+    }
+}
+
+void DecisionBits::fill(unsigned int run, unsigned int lumiblock, unsigned long long event, const std::vector<char>& tdt,
+                        const std::vector<char>& emulation) {
+    m_run = run;
+    m_lumiblock = lumiblock;
+    m_event = event;
+    pack(tdt, m_tdt);
+    pack(emulation, m_emulation);
+    m_tree->Fill();
+}
@@ -0,0 +1,73 @@
+#include "TriggerValidation/DeltaRMatcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // objects beyond are binned in the edge cells, which keeps neighbours
+    // within one cell of each other
+    const double ETA_MAX = 5.;
+    const double TWO_PI = 2. * M_PI;
+}
+
+DeltaRMatcher::DeltaRMatcher(double cone) : m_cone2(cone * cone) {
+    m_neta = std::max(1, (int)(2 * ETA_MAX / cone));
+    m_nphi = std::max(1, (int)(TWO_PI / cone));
+    m_eta_width = 2 * ETA_MAX / m_neta;
+    m_phi_width = TWO_PI / m_nphi;
+
+    m_head.assign(m_neta * m_nphi, -1);
+}
+
+void DeltaRMatcher::clear() {
+    for (int cell : m_used_cells) m_head[cell] = -1;
+    m_used_cells.clear();
+    m_next.clear();
+    m_eta.clear();
+    m_phi.clear();
+}
+
+void DeltaRMatcher::add(float eta, float phi) {
+    const int cell = etaCell(eta) * m_nphi + phiCell(phi);
+    if (m_head[cell] < 0) m_used_cells.push_back(cell);
+
+    m_next.push_back(m_head[cell]);
+    m_head[cell] = m_eta.size();
+    m_eta.push_back(eta);
+    m_phi.push_back(phi);
+}
+
+bool DeltaRMatcher::match(float eta, float phi) const {
+    if (m_eta.empty()) return false;
+
+    const int ieta = etaCell(eta);
+    const int iphi = phiCell(phi);
+
+    // with less than 3 phi cells all of them are neighbours
+    const int nphi = std::min(3, m_nphi);
+    const int first_phi = m_nphi < 3 ? 0 : iphi - 1 + m_nphi;
+
+    for (int e = std::max(0, ieta - 1); e <= std::min(m_neta - 1, ieta + 1); e++) {
+        for (int p = 0; p < nphi; p++) {
+            const int cell = e * m_nphi + (first_phi + p) % m_nphi;
+            for (int i = m_head[cell]; i >= 0; i = m_next[i]) {
+                const double deta = eta - m_eta[i];
+                const double dphi = std::remainder((double)phi - m_phi[i], TWO_PI);
+                if (deta * deta + dphi * dphi < m_cone2) return true;
+            }
+        }
+    }
+    return false;
+}
+
+int DeltaRMatcher::etaCell(float eta) const {
+    const int cell = (int)std::floor((eta + ETA_MAX) / m_eta_width);
+    return std::min(m_neta - 1, std::max(0, cell));
+}
+
+int DeltaRMatcher::phiCell(float phi) const {
+    // phi in [0, 2 pi)
+    double x = std::fmod((double)phi + M_PI, TWO_PI);
+    if (x < 0) x += TWO_PI;
+    return std::min(m_nphi - 1, (int)(x / m_phi_width));
+}
@@ -1,54 +1,122 @@
-
 #include "TriggerValidation/EffCurvesTool.h"
 
-EffCurvesTool::EffCurvesTool(const std::string& name) {
-    m_eff["leading_tau_pt"] = new TEfficiency(("lead_tau_pt_" + name).c_str(), "leading_tau", 16, 20, 100);
-    m_eff["subleading_tau_pt"] = new TEfficiency(("sublead_tau_pt_" + name).c_str(), "subleading_tau", 16, 20, 100);
-    m_eff["leading_tau_ntracks"] = new TEfficiency(("lead_tau_ntracks_" + name).c_str(), "leading_tau", 5, 0, 5);
-    m_eff["subleading_tau_ntracks"] = new TEfficiency(("sublead_tau_ntracks_" + name).c_str(), "subleading_tau", 5, 0, 5);
+#include <iostream>
+
+#include "TError.h"
 
+const char* EffCurvesTool::s_keys[EffCurvesTool::N_CURVES] = {
+    "delta_r",
+    "jet_eta",
+    "jet_pt",
+    "leading_tau_eta",
+    "leading_tau_ntracks",
+    "leading_tau_pt",
+    "subleading_tau_eta",
+    "subleading_tau_ntracks",
+    "subleading_tau_pt",
+};
+
+EffCurvesTool::EffCurvesTool(const std::string& name) : m_slots(1) {
+    m_eff.reserve(N_CURVES);
+    book(name);
+}
+
+EffCurvesTool::EffCurvesTool(const std::vector<std::string>& names) : m_slots(names.size()) {
+    // the multi-slot fills address the slots with 64 bit masks, the
+    // callers reject longer lists before booking
+    if (m_slots > MAX_SLOTS)
+        ::Error("EffCurvesTool", "%u slots booked, only the first %u can be filled", m_slots, MAX_SLOTS);
+
+    m_eff.reserve(m_slots * N_CURVES);
+    for (unsigned int i = 0; i < m_slots; i++) book(names[i]);
+}
+
+void EffCurvesTool::book(const std::string& name) {
     int Neta = 8;
     double bins_eta[] = {-2.4, -1.52, -1.37, -0.6, 0, 0.6, 1.37, 1.52, 2.4};
-    m_eff["leading_tau_eta"] = new TEfficiency(("lead_tau_eta_" + name).c_str(), "leading_tau", Neta, bins_eta);
-    m_eff["subleading_tau_eta"] = new TEfficiency(("sublead_tau_eta_" + name).c_str(), "subleading_tau", 20, -5, 5);
-
-    m_eff["jet_pt"] = new TEfficiency(("jet_pt_" + name).c_str(), "leading_jet", 8, 20, 100);
-    m_eff["jet_eta"] = new TEfficiency(("jet_eta_" + name).c_str(), "leading_jet", 10, -5, 5);
 
-    m_eff["delta_r"] = new TEfficiency(("delta_r_" + name).c_str(), "delta_r", 8, 0, 3.2);
+    m_eff.push_back(EfficiencyAccumulator("delta_r_" + name, "delta_r", 8, 0, 3.2));
+    m_eff.push_back(EfficiencyAccumulator("jet_eta_" + name, "leading_jet", 10, -5, 5));
+    m_eff.push_back(EfficiencyAccumulator("jet_pt_" + name, "leading_jet", 8, 20, 100));
+    m_eff.push_back(EfficiencyAccumulator("lead_tau_eta_" + name, "leading_tau", Neta, bins_eta));
+    m_eff.push_back(EfficiencyAccumulator("lead_tau_ntracks_" + name, "leading_tau", 5, 0, 5));
+    m_eff.push_back(EfficiencyAccumulator("lead_tau_pt_" + name, "leading_tau", 16, 20, 100));
+    m_eff.push_back(EfficiencyAccumulator("sublead_tau_eta_" + name, "subleading_tau", 20, -5, 5));
+    m_eff.push_back(EfficiencyAccumulator("sublead_tau_ntracks_" + name, "subleading_tau", 5, 0, 5));
+    m_eff.push_back(EfficiencyAccumulator("sublead_tau_pt_" + name, "subleading_tau", 16, 20, 100));
 }
 
 bool EffCurvesTool::fill_hadhad(bool pass, const xAOD::TauJet* t1, const xAOD::TauJet* t2, const xAOD::Jet* j1)
 
 {
-    m_eff["leading_tau_pt"]->Fill(pass, t1->pt() / 1000.);
-    m_eff["leading_tau_eta"]->Fill(pass, t1->eta());
-    m_eff["leading_tau_ntracks"]->Fill(pass, t1->nTracks());
+    return fill_hadhad(1ULL, pass ? 1ULL : 0ULL, t1, t2, j1);
+}
+
+bool EffCurvesTool::fill_lephad(bool pass, const xAOD::TauJet* t1) {
+    return fill_lephad(1ULL, pass ? 1ULL : 0ULL, t1);
+}
 
-    m_eff["subleading_tau_pt"]->Fill(pass, t2->pt() / 1000.);
-    m_eff["subleading_tau_eta"]->Fill(pass, t2->eta());
-    m_eff["subleading_tau_ntracks"]->Fill(pass, t2->nTracks());
+bool EffCurvesTool::fill_hadhad(unsigned long long filled, unsigned long long passed, const xAOD::TauJet* t1,
+                                const xAOD::TauJet* t2, const xAOD::Jet* j1) {
+    if (not booked(filled)) return false;
 
-    m_eff["jet_pt"]->Fill(pass, j1->pt() / 1000.);
-    m_eff["jet_eta"]->Fill(pass, j1->eta());
+    fill(LEADING_TAU_PT, t1->pt() / 1000., filled, passed);
+    fill(LEADING_TAU_ETA, t1->eta(), filled, passed);
+    fill(LEADING_TAU_NTRACKS, t1->nTracks(), filled, passed);
 
-    m_eff["delta_r"]->Fill(pass, t1->p4().DeltaR(t2->p4()));
+    fill(SUBLEADING_TAU_PT, t2->pt() / 1000., filled, passed);
+    fill(SUBLEADING_TAU_ETA, t2->eta(), filled, passed);
+    fill(SUBLEADING_TAU_NTRACKS, t2->nTracks(), filled, passed);
+
+    fill(JET_PT, j1->pt() / 1000., filled, passed);
+    fill(JET_ETA, j1->eta(), filled, passed);
+
+    fill(DELTA_R, t1->p4().DeltaR(t2->p4()), filled, passed);
 
     return true;
 }
 
-bool EffCurvesTool::fill_lephad(bool pass, const xAOD::TauJet* t1) {
-    m_eff["leading_tau_pt"]->Fill(pass, t1->pt() / 1000.);
-    m_eff["leading_tau_eta"]->Fill(pass, t1->eta());
-    m_eff["leading_tau_ntracks"]->Fill(pass, t1->nTracks());
+bool EffCurvesTool::fill_lephad(unsigned long long filled, unsigned long long passed, const xAOD::TauJet* t1) {
+    if (not booked(filled)) return false;
+
+    fill(LEADING_TAU_PT, t1->pt() / 1000., filled, passed);
+    fill(LEADING_TAU_ETA, t1->eta(), filled, passed);
+    fill(LEADING_TAU_NTRACKS, t1->nTracks(), filled, passed);
 
     return true;
 }
 
+bool EffCurvesTool::booked(unsigned long long filled) const {
+    if (m_slots >= MAX_SLOTS) return true;
+    if ((filled >> m_slots) == 0) return true;
+
+    ::Error("EffCurvesTool", "fill of slot %u, only %u slots are booked", 63 - __builtin_clzll(filled), m_slots);
+    return false;
+}
+
+void EffCurvesTool::fill(Curve curve, double x, unsigned long long filled, unsigned long long passed) {
+    // all the slots share the binning of slot 0
+    const int bin = m_eff[curve].findBin(x);
+
+    // loop over the set bits only
+    for (unsigned long long bits = filled; bits != 0; bits &= bits - 1) {
+        const unsigned int slot = __builtin_ctzll(bits);
+        m_eff[slot * N_CURVES + curve].fillBin(bin, (passed >> slot) & 1);
+    }
+}
+
+std::map<std::string, std::unique_ptr<TEfficiency> > EffCurvesTool::Efficiencies(unsigned int slot) const {
+    std::map<std::string, std::unique_ptr<TEfficiency> > effs;
+    for (int i = 0; i < N_CURVES; i++) effs[s_keys[i]].reset(m_eff[slot * N_CURVES + i].efficiency());
+    return effs;
+}
+
 void EffCurvesTool::record(EL::Worker* wk) {
-    for (auto eff : m_eff) {
-        std::cout << eff.second->GetName() << std::endl;
-        // wk->addOutput((TH1F*)eff.second->GetPassedHistogram());
-        // wk->addOutput((TH1F*)eff.second->GetTotalHistogram());
+    for (unsigned int slot = 0; slot < m_slots; slot++) {
+        for (auto& eff : Efficiencies(slot)) {
+            std::cout << eff.second->GetName() << std::endl;
+            // the worker takes ownership
+            wk->addOutput(eff.second.release());
+        }
     }
 }
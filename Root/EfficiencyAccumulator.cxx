@@ -0,0 +1,76 @@
+#include "TriggerValidation/EfficiencyAccumulator.h"
+
+#include <algorithm>
+
+EfficiencyAccumulator::EfficiencyAccumulator(const std::string& name, const std::string& title, int nbins, double low,
+                                             double high)
+    : m_name(name),
+      m_title(title),
+      m_nbins(nbins),
+      m_low(low),
+      m_high(high),
+      m_cell_width(0),
+      m_passed(nbins + 2, 0),
+      m_total(nbins + 2, 0) {}
+
+EfficiencyAccumulator::EfficiencyAccumulator(const std::string& name, const std::string& title, int nbins,
+                                             const double* edges)
+    : m_name(name),
+      m_title(title),
+      m_nbins(nbins),
+      m_low(edges[0]),
+      m_high(edges[nbins]),
+      m_edges(edges, edges + nbins + 1),
+      m_cell_width(0),
+      m_passed(nbins + 2, 0),
+      m_total(nbins + 2, 0) {
+    buildLookup();
+}
+
+void EfficiencyAccumulator::buildLookup() {
+    // cells a few times finer than the narrowest bin: at most one edge
+    // is crossed after the lookup
+    double min_width = m_high - m_low;
+    for (int i = 0; i < m_nbins; i++) min_width = std::min(min_width, m_edges[i + 1] - m_edges[i]);
+
+    int ncells = std::min(10000, (int)(4 * (m_high - m_low) / min_width) + 1);
+    m_cell_width = (m_high - m_low) / ncells;
+
+    m_lookup.resize(ncells);
+    for (int cell = 0; cell < ncells; cell++) {
+        const double x = m_low + cell * m_cell_width;
+        m_lookup[cell] = std::upper_bound(m_edges.begin(), m_edges.end(), x) - m_edges.begin();
+    }
+}
+
+int EfficiencyAccumulator::findBin(double x) const {
+    if (x < m_low) return 0;
+    if (!(x < m_high)) return m_nbins + 1;
+
+    if (m_edges.empty()) return 1 + int(m_nbins * (x - m_low) / (m_high - m_low));
+
+    int cell = std::min((int)((x - m_low) / m_cell_width), (int)m_lookup.size() - 1);
+    int bin = m_lookup[cell];
+    // the cell can start below x but span the next edge(s)
+    while (bin < m_nbins and x >= m_edges[bin]) bin++;
+    // or start above x because of rounding
+    while (bin > 1 and x < m_edges[bin - 1]) bin--;
+    return bin;
+}
+
+TEfficiency* EfficiencyAccumulator::efficiency() const {
+    TEfficiency* eff = NULL;
+    if (m_edges.empty())
+        eff = new TEfficiency(m_name.c_str(), m_title.c_str(), m_nbins, m_low, m_high);
+    else
+        eff = new TEfficiency(m_name.c_str(), m_title.c_str(), m_nbins, m_edges.data());
+    eff->SetDirectory(0);
+
+    // total first: TEfficiency refuses more passed than total events
+    for (int bin = 0; bin < m_nbins + 2; bin++) {
+        if (m_total[bin] == 0) continue;
+        eff->SetTotalEvents(bin, m_total[bin]);
+        eff->SetPassedEvents(bin, m_passed[bin]);
+    }
+    return eff;
+}
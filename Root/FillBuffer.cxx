@@ -0,0 +1,32 @@
+#include "TriggerValidation/FillBuffer.h"
+
+FillBuffer::FillBuffer(TH1* hist, unsigned int size) : m_hist(hist), m_size(0) {
+    setSize(size);
+}
+
+void FillBuffer::setHist(TH1* hist) {
+    flush();
+    m_hist = hist;
+}
+
+void FillBuffer::setSize(unsigned int size) {
+    flush();
+    m_size = size > 0 ? size : 1;
+    m_x.reserve(m_size);
+    m_weights.reserve(m_size);
+}
+
+void FillBuffer::flush() {
+    if (m_x.empty()) return;
+
+    if (m_hist != NULL) {
+        if (m_y.empty())
+            m_hist->FillN(m_x.size(), m_x.data(), m_weights.data());
+        else
+            m_hist->FillN(m_x.size(), m_x.data(), m_y.data(), m_weights.data(), 1);
+    }
+
+    m_x.clear();
+    m_y.clear();
+    m_weights.clear();
+}
@@ -1,10 +1,13 @@
 // vim: ts=2 sw=2
 
 #include <EventLoop/Job.h>
+#include <EventLoop/OutputStream.h>
 #include <EventLoop/StatusCode.h>
 #include <EventLoop/Worker.h>
 #include <TriggerValidation/HLTEmulationLoop.h>
 
+#include "TFile.h"
+
 #include "xAODRootAccess/Init.h"
 #include "xAODRootAccess/TEvent.h"
 #include "xAODRootAccess/tools/Message.h"
@@ -76,7 +79,7 @@ void clearContainer(T &c) {
     }
 }
 
-HLTEmulationLoop::HLTEmulationLoop() {
+HLTEmulationLoop::HLTEmulationLoop() : print_mismatches(false) {
     // Here you put any code for the base initialization of variables,
     // e.g. initialize all pointers to 0.  Note that you should only put
     // the most basic initialization here, since this method will be
@@ -88,6 +91,9 @@ HLTEmulationLoop::HLTEmulationLoop() {
 EL::StatusCode HLTEmulationLoop::setupJob(EL::Job &job) {
     job.useXAOD();
     EL_RETURN_CHECK("setupJob ()", xAOD::Init());
+
+    // side file of the events where the TDT and the emulation disagree
+    job.outputAdd(EL::OutputStream("hlt_mismatches"));
     return EL::StatusCode::SUCCESS;
 }
 
@@ -107,6 +113,13 @@ EL::StatusCode HLTEmulationLoop::histInitialize() {
     wk()->addOutput(h_TDT_EMU_diff);
     wk()->addOutput(h_TDT_fires);
     wk()->addOutput(h_EMU_fires);
+
+    h_event_gates = new TH1F("h_event_gates", "events_skipped_before_the_EDM_reads", 4, 0, 4);
+    h_event_gates->GetXaxis()->SetBinLabel(1, "events");
+    h_event_gates->GetXaxis()->SetBinLabel(2, "failed_reference");
+    h_event_gates->GetXaxis()->SetBinLabel(3, "failed_preselection");
+    h_event_gates->GetXaxis()->SetBinLabel(4, "avoided_reads");
+    wk()->addOutput(h_event_gates);
     return EL::StatusCode::SUCCESS;
 }
 
@@ -120,6 +133,9 @@ EL::StatusCode HLTEmulationLoop::changeInput(bool /*firstFile*/) {
     // Here you do everything you need to do when we change input files,
     // e.g. resetting branch addresses on trees.  If you are using
     // D3PDReader or a similar service this method is not needed.
+    const std::string file = wk()->inputFile()->GetName();
+    m_replay.select(replay_files, replay_entries, file);
+    m_mismatches.setInput(file);
     return EL::StatusCode::SUCCESS;
 }
 
@@ -187,6 +203,25 @@ EL::StatusCode HLTEmulationLoop::initialize() {
         m_hlt_emulationTool->msg().setLevel(MSG::VERBOSE);
     }
 
+    // chain groups are looked up by regex, only do it once
+    m_hlt_chains.clear();
+    m_chain_labels.clear();
+    m_chain_groups.clear();
+    for (auto &ch : m_hlt_emulationTool->getHltChains()) {
+        std::string label = ch.first;
+        trim(label);
+        m_hlt_chains.push_back(ch.first);
+        m_chain_labels.push_back(label);
+        m_chain_groups.push_back(m_trigDecisionTool->getChainGroup(label));
+    }
+    m_reference_group = m_trigDecisionTool->getChainGroup(reference_chain);
+
+    m_mismatches.book(wk()->getOutputFile("hlt_mismatches"), m_chain_labels);
+
+    m_n_events = 0;
+    m_n_copied = 0;
+    m_n_copied_former = 0;
+
     xAOD::TEvent *event = wk()->xaodEvent();
 
     // MY_MSG_INFO("Number of events = " << event->getEntries());
@@ -196,6 +231,11 @@ EL::StatusCode HLTEmulationLoop::initialize() {
 }
 
 EL::StatusCode HLTEmulationLoop::execute() {
+    // in replay mode, skip the other entries before reading anything
+    if (not m_replay.contains(wk()->treeEntry())) {
+        return EL::StatusCode::SUCCESS;
+    }
+
     xAOD::TEvent *event = wk()->xaodEvent();
     MY_MSG_VERBOSE("--------------------------");
     MY_MSG_VERBOSE("Read event number " << wk()->treeEntry() << " / " << event->getEntries());
@@ -208,6 +248,29 @@ EL::StatusCode HLTEmulationLoop::execute() {
     // std::cout << "GOT BASE EXTENSION " << extension->name() << std::endl;
     //}
 
+    // the reference chain and its preselection taus are checked before
+    // any EDM object is retrieved: most events stop there, and skip the
+    // EventInfo and L1 container reads
+    const unsigned int n_edm_reads = 5;
+    h_event_gates->Fill(0);
+
+    if (not m_reference_group->isPassed(trigger_condition)) {
+        h_event_gates->Fill(1);
+        h_event_gates->Fill(3, n_edm_reads);
+        return EL::StatusCode::SUCCESS;
+    }
+
+    auto features = m_reference_group->features(trigger_condition);
+
+    // the preselection taus and the tracks are only read through the
+    // feature containers, nothing is copied
+    auto tauPreselFeatures = features.containerFeature<xAOD::TauJetContainer>("TrigTauRecPreselection");
+    if (tauPreselFeatures.size() != 1) {
+        h_event_gates->Fill(2);
+        h_event_gates->Fill(3, n_edm_reads);
+        return EL::StatusCode::SUCCESS;
+    }
+
     // retrieve the EDM objects
     const xAOD::EventInfo *ei = 0;
     EL_RETURN_CHECK("execute", event->retrieve(ei, "EventInfo"));
@@ -224,30 +287,6 @@ EL::StatusCode HLTEmulationLoop::execute() {
     const xAOD::EnergySumRoI *l1xe = 0;
     EL_RETURN_CHECK("execute", event->retrieve(l1xe, "LVL1EnergySumRoI"));
 
-    if (not m_trigDecisionTool->isPassed(reference_chain, trigger_condition)) {
-        return EL::StatusCode::SUCCESS;
-    }
-
-    auto cg = m_trigDecisionTool->getChainGroup(reference_chain);
-    auto features = cg->features(trigger_condition);
-
-    xAOD::TauJetContainer *presel_taus = new xAOD::TauJetContainer();
-    xAOD::TauJetAuxContainer *presel_taus_aux = new xAOD::TauJetAuxContainer();
-    presel_taus->setStore(presel_taus_aux);
-    auto tauPreselFeatures = features.containerFeature<xAOD::TauJetContainer>("TrigTauRecPreselection");
-    for (auto &tauContainer : tauPreselFeatures) {
-        if (!tauContainer.cptr()) {
-            continue;
-        }
-        for (auto tau : *tauContainer.cptr()) {
-            xAOD::TauJet *new_tau = new xAOD::TauJet();
-            new_tau->makePrivateStore(tau);
-            presel_taus->push_back(new_tau);
-        }
-    }
-
-    if (tauPreselFeatures.size() != 1) return EL::StatusCode::SUCCESS;
-
     // get the tracking info
     // NOTE: we should fix this in two ways
     // 1) only ask for this when needed (an idperf chain is the reference)
@@ -256,59 +295,35 @@ EL::StatusCode HLTEmulationLoop::execute() {
     auto preselTracksCoreFeatures =
         features.containerFeature<xAOD::TrackParticleContainer>("InDetTrigTrackingxAODCnv_TauCore_FTF");
 
-    xAOD::TrackParticleContainer *preselTracksIso = new xAOD::TrackParticleContainer();
-    xAOD::TrackParticleContainer *preselTracksCore = new xAOD::TrackParticleContainer();
-    xAOD::TrackParticleAuxContainer *preselTracksIsoAux = new xAOD::TrackParticleAuxContainer();
-    xAOD::TrackParticleAuxContainer *preselTracksCoreAux = new xAOD::TrackParticleAuxContainer();
-
-    preselTracksIso->setStore(preselTracksIsoAux);
-    preselTracksCore->setStore(preselTracksCoreAux);
-
     MY_MSG_VERBOSE("Core Tracks containers size = " << preselTracksCoreFeatures.size());
     MY_MSG_VERBOSE("Iso Tracks containers size = " << preselTracksIsoFeatures.size());
 
-    // iso tracks
+    // objects the extraction used to deep-copy, for the allocation report
+    unsigned long n_presel_objects = 0;
+    for (auto &tauContainer : tauPreselFeatures) {
+        if (tauContainer.cptr()) n_presel_objects += tauContainer.cptr()->size();
+    }
     for (auto &trackContainer : preselTracksIsoFeatures) {
-        if (!trackContainer.cptr()) {
-            continue;
-        }
-        for (auto track : *trackContainer.cptr()) {
-            xAOD::TrackParticle *new_track = new xAOD::TrackParticle();
-            new_track->makePrivateStore(track);
-            preselTracksIso->push_back(new_track);
-        }
+        if (trackContainer.cptr()) n_presel_objects += trackContainer.cptr()->size();
     }
-
-    // core tracks
     for (auto &trackContainer : preselTracksCoreFeatures) {
-        if (!trackContainer.cptr()) {
-            continue;
-        }
-        for (auto track : *trackContainer.cptr()) {
-            xAOD::TrackParticle *new_track = new xAOD::TrackParticle();
-            new_track->makePrivateStore(track);
-            preselTracksCore->push_back(new_track);
-        }
+        if (trackContainer.cptr()) n_presel_objects += trackContainer.cptr()->size();
     }
 
+    // the HLT taus handed to the emulation are copied once, into containers
+    // owning them for the duration of the event
     xAOD::TauJetContainer *hlt_taus = new xAOD::TauJetContainer();
     xAOD::TauJetAuxContainer *hlt_taus_aux = new xAOD::TauJetAuxContainer();
     hlt_taus->setStore(hlt_taus_aux);
 
+    xAOD::TauJetContainer *caloOnly_taus = new xAOD::TauJetContainer();
+    xAOD::TauJetAuxContainer *caloOnly_taus_aux = new xAOD::TauJetAuxContainer();
+    caloOnly_taus->setStore(caloOnly_taus_aux);
+
     // TODO: should be a flag
     std::string hltTauContainerName = "TrigTauRecMerged";
     auto tauHltFeatures = features.containerFeature<xAOD::TauJetContainer>(hltTauContainerName);
     MY_MSG_VERBOSE("HLT Tau containers size = " << tauHltFeatures.size());
-    for (auto &tauContainer : tauHltFeatures) {
-        if (!tauContainer.cptr()) {
-            continue;
-        }
-        for (auto tau : *tauContainer.cptr()) {
-            xAOD::TauJet *new_tau = new xAOD::TauJet();
-            new_tau->makePrivateStore(tau);
-            hlt_taus->push_back(new_tau);
-        }
-    }
 
     std::string caloOnlyTauContainerName = "HLT_xAOD__TauJetContainer_TrigTauRecCaloOnly";
     decltype(features.containerFeature<xAOD::TauJetContainer>()) tauCaloOnlyFeatures;
@@ -321,6 +336,16 @@ EL::StatusCode HLTEmulationLoop::execute() {
         MY_MSG_VERBOSE("CaloOnly Tau containers size = " << tauHltFeatures.size());
     }
 
+    // index the features by RoI once, instead of testing every tau
+    // container against every other container
+    m_roi_index.clear();
+    m_roi_index.add(RoIFeatureIndex::ISO_TRACKS, preselTracksIsoFeatures);
+    m_roi_index.add(RoIFeatureIndex::CORE_TRACKS, preselTracksCoreFeatures);
+    if (hasCaloOnlyTaus) {
+        m_roi_index.add(RoIFeatureIndex::CALO_ONLY_TAUS, tauCaloOnlyFeatures);
+    }
+    MY_MSG_VERBOSE("Features indexed in " << m_roi_index.rois() << " RoIs");
+
     // make a bunch of decorated HLT taus
     std::vector<DecoratedHltTau> decoratedTaus;
     for (auto &tauContainer : tauHltFeatures) {
@@ -328,52 +353,51 @@ EL::StatusCode HLTEmulationLoop::execute() {
             continue;
         }
 
+        // the associated features are the same for every tau of the
+        // container, the navigation is only walked once
+        m_roi_index.find(tauContainer.te());
+
         for (auto tau : *tauContainer.cptr()) {
             xAOD::TauJet *new_tau = new xAOD::TauJet();
-            new_tau->makePrivateStore(tau);
+            hlt_taus->push_back(new_tau);
+            *new_tau = *tau;
             DecoratedHltTau d(new_tau);
 
             // find the iso and core tracks for this guy
-            for (auto &trackContainer : preselTracksIsoFeatures) {
-                if (HLT::TrigNavStructure::haveCommonRoI(tauContainer.te(), trackContainer.te())) {
-                    // std::cout << "GOT AN Iso MATCH" << std::endl;
-                    if (!trackContainer.cptr()) {
-                        continue;
-                    }
-                    d.addPreselTracksIso(trackContainer.cptr());
+            for (unsigned int i : m_roi_index.found(RoIFeatureIndex::ISO_TRACKS)) {
+                auto &trackContainer = preselTracksIsoFeatures[i];
+                if (!trackContainer.cptr()) {
+                    continue;
                 }
+                d.addPreselTracksIso(trackContainer.cptr());
             }
 
-            for (auto &trackContainer : preselTracksCoreFeatures) {
-                if (HLT::TrigNavStructure::haveCommonRoI(tauContainer.te(), trackContainer.te())) {
-                    // std::cout << "GOT AN Core MATCH" << std::endl;
-                    if (!trackContainer.cptr()) {
-                        continue;
-                    }
-                    d.addPreselTracksCore(trackContainer.cptr());
+            for (unsigned int i : m_roi_index.found(RoIFeatureIndex::CORE_TRACKS)) {
+                auto &trackContainer = preselTracksCoreFeatures[i];
+                if (!trackContainer.cptr()) {
+                    continue;
                 }
+                d.addPreselTracksCore(trackContainer.cptr());
             }
 
             if (hasCaloOnlyTaus) {
-                for (auto &caloOnlyTauContainer : tauCaloOnlyFeatures) {
+                for (unsigned int i : m_roi_index.found(RoIFeatureIndex::CALO_ONLY_TAUS)) {
+                    auto &caloOnlyTauContainer = tauCaloOnlyFeatures[i];
                     if (!caloOnlyTauContainer.cptr()) {
                         continue;
                     }
-                    if (not HLT::TrigNavStructure::haveCommonRoI(tauContainer.te(), caloOnlyTauContainer.te())) {
-                        continue;
-                    }
 
                     for (auto caloOnlyTau : *caloOnlyTauContainer.cptr()) {
                         // NOTE: we assume this is of size 1
                         xAOD::TauJet *new_caloOnly_tau = new xAOD::TauJet();
-                        new_caloOnly_tau->makePrivateStore(caloOnlyTau);
+                        caloOnly_taus->push_back(new_caloOnly_tau);
+                        *new_caloOnly_tau = *caloOnlyTau;
                         d.setCaloOnyTau(new_caloOnly_tau);
                         break;
                     }
                 }
             }
 
-            std::cout << d << std::endl;
             decoratedTaus.push_back(d);
         }
     }
@@ -382,13 +406,14 @@ EL::StatusCode HLTEmulationLoop::execute() {
     // preselTracksCore));
     EL_RETURN_CHECK("execute", m_hlt_emulationTool->execute(l1taus, l1jets, l1muons, l1xe, decoratedTaus));
 
+    m_mismatches.clear(wk()->treeEntry(), ei->runNumber(), ei->eventNumber(), ei->lumiBlock());
+
     // for (auto it: chains_to_test) {
-    for (auto &ch : m_hlt_emulationTool->getHltChains()) {
-        auto name = ch.first;
-        bool emulation_decision = m_hlt_emulationTool->decision(name);
+    for (unsigned int ich = 0; ich < m_hlt_chains.size(); ich++) {
+        const std::string &name = m_chain_labels[ich];
+        bool emulation_decision = m_hlt_emulationTool->decision(m_hlt_chains[ich]);
 
-        auto chain_group = m_trigDecisionTool->getChainGroup(trim(name));
-        bool cg_passes_event = chain_group->isPassed(trigger_condition);
+        bool cg_passes_event = m_chain_groups[ich]->isPassed(trigger_condition);
         if (cg_passes_event) {
             h_TDT_fires->Fill(name.c_str(), 1);
         }
@@ -399,6 +424,10 @@ EL::StatusCode HLTEmulationLoop::execute() {
 
         if (emulation_decision != cg_passes_event) {
             h_TDT_EMU_diff->Fill(name.c_str(), 1);
+            m_mismatches.addChain(ich, cg_passes_event, emulation_decision);
+            if (not print_mismatches) {
+                continue;
+            }
             // if(emulation_decision) {
             // 	++fire_difference_emu[name];
             // } else {
@@ -416,28 +445,34 @@ EL::StatusCode HLTEmulationLoop::execute() {
         }
     }
 
-    clearContainer(presel_taus);
+    // record the disagreements with the L1 taus and the HLT taus handed to
+    // the emulation
+    if (m_mismatches.size() > 0) {
+        m_mismatches.addEmTauRoIs(*l1taus);
+        m_mismatches.addObjects(MismatchRecorder::HLT_TAU, *hlt_taus, [](const xAOD::TauJet *t) { return t->pt(); });
+        m_mismatches.addObjects(MismatchRecorder::HLT_CALO_ONLY_TAU, *caloOnly_taus,
+                                [](const xAOD::TauJet *t) { return t->pt(); });
+        m_mismatches.write();
+
+        // the decorated HLT taus of the disagreeing events only
+        if (print_mismatches) {
+            for (auto &d : decoratedTaus) {
+                std::cout << d << std::endl;
+            }
+        }
+    }
+
+    m_n_events++;
+    m_n_copied += hlt_taus->size() + caloOnly_taus->size();
+    m_n_copied_former += n_presel_objects + 2 * hlt_taus->size() + caloOnly_taus->size();
+
     clearContainer(hlt_taus);
-    clearContainer(preselTracksIso);
-    clearContainer(preselTracksCore);
+    clearContainer(caloOnly_taus);
 
     delete hlt_taus;
-    delete presel_taus;
-    delete preselTracksIso;
-    delete preselTracksCore;
-
-    if (hlt_taus_aux) {
-        delete hlt_taus_aux;
-    }
-    if (presel_taus_aux) {
-        delete presel_taus_aux;
-    }
-    if (preselTracksIsoAux) {
-        delete preselTracksIsoAux;
-    }
-    if (preselTracksCoreAux) {
-        delete preselTracksCoreAux;
-    }
+    delete caloOnly_taus;
+    delete hlt_taus_aux;
+    delete caloOnly_taus_aux;
 
     return EL::StatusCode::SUCCESS;
 }
@@ -450,6 +485,13 @@ EL::StatusCode HLTEmulationLoop::postExecute() {
 }
 
 EL::StatusCode HLTEmulationLoop::finalize() {
+    if (m_n_events > 0) {
+        Info("finalize()",
+             "HLT objects copied per event: %.2f (former extraction, estimated from the container sizes: %.2f) "
+             "over %llu events",
+             (double)m_n_copied / m_n_events, (double)m_n_copied_former / m_n_events, m_n_events);
+    }
+
     if (m_trigConfigTool) {
         m_trigConfigTool = nullptr;
         delete m_trigConfigTool;
@@ -1,97 +1,107 @@
 #include "TriggerValidation/HistogramsBook.h"
 
-HistogramsBook::HistogramsBook(const std::string& name) : m_name(name) {}
+// name (h_<name> in the output), title and binning of each histogram
+const HistogramsBook::Schema HistogramsBook::s_schema[HistogramsBook::N_HISTS] = {
+    {"jet1_eta", "jet1_eta", 10, -2.5, 2.5},
+    {"jet1_phi", "jet1_phi", 10, -3.15, 3.15},
+    {"jet1_pt", "jet1_pt", 40, 0, 100},
+    {"jet2_eta", "jet2_eta", 10, -2.5, 2.5},
+    {"jet2_phi", "jet2_phi", 10, -3.15, 3.15},
+    {"jet2_pt", "jet2_pt", 40, 0, 100},
+    {"tau1_bdt", "tau1_bdt", 10, 0, 1},
+    {"tau1_eta", "tau1_eta", 10, -2.5, 2.5},
+    {"tau1_ntracks", "tau1_ntracks", 5, 0, 5},
+    {"tau1_phi", "tau1_phi", 10, -3.15, 3.15},
+    {"tau1_pt", "tau1_pt", 40, 0, 100},
+    {"tau2_bdt", "tau2_bdt", 10, 0, 1},
+    {"tau2_eta", "tau2_eta", 10, -2.5, 2.5},
+    {"tau2_ntracks", "tau2_ntracks", 5, 0, 5},
+    {"tau2_phi", "tau2_phi", 10, -3.15, 3.15},
+    {"tau2_pt", "tau2_pt", 40, 0, 100},
+    {"tautau_dr", "dr_tau_tau", 16, 0, 3.2},
+    {"truth_tau1_eta", "truth_tau1_eta", 10, -2.5, 2.5},
+    {"truth_tau1_phi", "truth_tau1_phi", 10, -3.15, 3.15},
+    {"truth_tau1_pt", "truth_tau1_pt", 40, 0, 100},
+    {"truth_tau2_eta", "truth_tau2_eta", 10, -2.5, 2.5},
+    {"truth_tau2_phi", "truth_tau2_phi", 10, -3.15, 3.15},
+    {"truth_tau2_pt", "truth_tau2_pt", 40, 0, 100},
+};
+
+const SG::AuxElement::ConstAccessor<double> HistogramsBook::s_pt_vis("pt_vis");
+const SG::AuxElement::ConstAccessor<double> HistogramsBook::s_eta_vis("eta_vis");
+const SG::AuxElement::ConstAccessor<double> HistogramsBook::s_phi_vis("phi_vis");
+
+HistogramsBook::HistogramsBook(const std::string& name) : m_name(name) {
+    for (int i = 0; i < N_HISTS; i++) m_h1d[i] = NULL;
+}
 
 void HistogramsBook::book() {
-    // tau1
-    m_h1d["tau1_pt"] = new TH1F((m_name + "/h_tau1_pt").c_str(), "tau1_pt", 40, 0, 100);
-    m_h1d["tau1_eta"] = new TH1F((m_name + "/h_tau1_eta").c_str(), "tau1_eta", 10, -2.5, 2.5);
-    m_h1d["tau1_phi"] = new TH1F((m_name + "/h_tau1_phi").c_str(), "tau1_phi", 10, -3.15, 3.15);
-    m_h1d["tau1_ntracks"] = new TH1F((m_name + "/h_tau1_ntracks").c_str(), "tau1_ntracks", 5, 0, 5);
-    m_h1d["tau1_bdt"] = new TH1F((m_name + "/h_tau1_bdt").c_str(), "tau1_bdt", 10, 0, 1);
-
-    // tau 2
-    m_h1d["tau2_pt"] = new TH1F((m_name + "/h_tau2_pt").c_str(), "tau2_pt", 40, 0, 100);
-    m_h1d["tau2_eta"] = new TH1F((m_name + "/h_tau2_eta").c_str(), "tau2_eta", 10, -2.5, 2.5);
-    m_h1d["tau2_phi"] = new TH1F((m_name + "/h_tau2_phi").c_str(), "tau2_phi", 10, -3.15, 3.15);
-    m_h1d["tau2_ntracks"] = new TH1F((m_name + "/h_tau2_ntracks").c_str(), "tau2_ntracks", 5, 0, 5);
-    m_h1d["tau2_bdt"] = new TH1F((m_name + "/h_tau2_bdt").c_str(), "tau2_bdt", 10, 0, 1);
-
-    // jet1
-    m_h1d["jet1_pt"] = new TH1F((m_name + "/h_jet1_pt").c_str(), "jet1_pt", 40, 0, 100);
-    m_h1d["jet1_eta"] = new TH1F((m_name + "/h_jet1_eta").c_str(), "jet1_eta", 10, -2.5, 2.5);
-    m_h1d["jet1_phi"] = new TH1F((m_name + "/h_jet1_phi").c_str(), "jet1_phi", 10, -3.15, 3.15);
-
-    // jet 2
-    m_h1d["jet2_pt"] = new TH1F((m_name + "/h_jet2_pt").c_str(), "jet2_pt", 40, 0, 100);
-    m_h1d["jet2_eta"] = new TH1F((m_name + "/h_jet2_eta").c_str(), "jet2_eta", 10, -2.5, 2.5);
-    m_h1d["jet2_phi"] = new TH1F((m_name + "/h_jet2_phi").c_str(), "jet2_phi", 10, -3.15, 3.15);
-
-    // truth_tau1
-    m_h1d["truth_tau1_pt"] = new TH1F((m_name + "/h_truth_tau1_pt").c_str(), "truth_tau1_pt", 40, 0, 100);
-    m_h1d["truth_tau1_eta"] = new TH1F((m_name + "/h_truth_tau1_eta").c_str(), "truth_tau1_eta", 10, -2.5, 2.5);
-    m_h1d["truth_tau1_phi"] = new TH1F((m_name + "/h_truth_tau1_phi").c_str(), "truth_tau1_phi", 10, -3.15, 3.15);
+    for (int i = 0; i < N_HISTS; i++) {
+        const Schema& h = s_schema[i];
+        m_h1d[i] = new TH1F((m_name + "/h_" + h.name).c_str(), h.title, h.nbins, h.low, h.high);
+        m_buffers[i].setHist(m_h1d[i]);
+    }
+}
 
-    // truth_tau 2
-    m_h1d["truth_tau2_pt"] = new TH1F((m_name + "/h_truth_tau2_pt").c_str(), "truth_tau2_pt", 40, 0, 100);
-    m_h1d["truth_tau2_eta"] = new TH1F((m_name + "/h_truth_tau2_eta").c_str(), "truth_tau2_eta", 10, -2.5, 2.5);
-    m_h1d["truth_tau2_phi"] = new TH1F((m_name + "/h_truth_tau2_phi").c_str(), "truth_tau2_phi", 10, -3.15, 3.15);
+void HistogramsBook::setBufferSize(unsigned int size) {
+    for (int i = 0; i < N_HISTS; i++) m_buffers[i].setSize(size);
+}
 
-    // tau-tau system
-    m_h1d["tautau_dr"] = new TH1F((m_name + "/h_tautau_dr").c_str(), "dr_tau_tau", 16, 0, 3.2);
+void HistogramsBook::flush() {
+    for (int i = 0; i < N_HISTS; i++) m_buffers[i].flush();
 }
 
 void HistogramsBook::fill_tau(const xAOD::TauJet* tau1, const xAOD::TauJet* tau2, const double& weight) {
     if (tau1 != NULL) {
-        m_h1d["tau1_pt"]->Fill(tau1->pt() / 1000., weight);
-        m_h1d["tau1_eta"]->Fill(tau1->eta(), weight);
-        m_h1d["tau1_phi"]->Fill(tau1->phi(), weight);
-        m_h1d["tau1_ntracks"]->Fill(tau1->nTracks(), weight);
-        m_h1d["tau1_bdt"]->Fill(tau1->discriminant(xAOD::TauJetParameters::TauID::BDTJetScore), weight);
+        m_buffers[TAU1_PT].fill(tau1->pt() / 1000., weight);
+        m_buffers[TAU1_ETA].fill(tau1->eta(), weight);
+        m_buffers[TAU1_PHI].fill(tau1->phi(), weight);
+        m_buffers[TAU1_NTRACKS].fill(tau1->nTracks(), weight);
+        m_buffers[TAU1_BDT].fill(tau1->discriminant(xAOD::TauJetParameters::TauID::BDTJetScore), weight);
     }
 
     if (tau2 != NULL) {
-        m_h1d["tau2_pt"]->Fill(tau2->pt() / 1000., weight);
-        m_h1d["tau2_eta"]->Fill(tau2->eta(), weight);
-        m_h1d["tau2_phi"]->Fill(tau2->phi(), weight);
-        m_h1d["tau2_ntracks"]->Fill(tau2->nTracks(), weight);
-        m_h1d["tau2_bdt"]->Fill(tau2->discriminant(xAOD::TauJetParameters::TauID::BDTJetScore), weight);
+        m_buffers[TAU2_PT].fill(tau2->pt() / 1000., weight);
+        m_buffers[TAU2_ETA].fill(tau2->eta(), weight);
+        m_buffers[TAU2_PHI].fill(tau2->phi(), weight);
+        m_buffers[TAU2_NTRACKS].fill(tau2->nTracks(), weight);
+        m_buffers[TAU2_BDT].fill(tau2->discriminant(xAOD::TauJetParameters::TauID::BDTJetScore), weight);
     }
 
-    if (tau1 != NULL and tau2 != NULL) m_h1d["tautau_dr"]->Fill(tau1->p4().DeltaR(tau2->p4()), weight);
+    if (tau1 != NULL and tau2 != NULL) m_buffers[TAUTAU_DR].fill(tau1->p4().DeltaR(tau2->p4()), weight);
 }
 
 void HistogramsBook::fill_jet(const xAOD::Jet* j1, const xAOD::Jet* j2, const double& weight) {
     if (j1 != NULL) {
-        m_h1d["jet1_pt"]->Fill(j1->pt() / 1000., weight);
-        m_h1d["jet1_eta"]->Fill(j1->eta(), weight);
-        m_h1d["jet1_phi"]->Fill(j1->phi(), weight);
+        m_buffers[JET1_PT].fill(j1->pt() / 1000., weight);
+        m_buffers[JET1_ETA].fill(j1->eta(), weight);
+        m_buffers[JET1_PHI].fill(j1->phi(), weight);
     }
 
     if (j2 != NULL) {
-        m_h1d["jet2_pt"]->Fill(j2->pt() / 1000., weight);
-        m_h1d["jet2_eta"]->Fill(j2->eta(), weight);
-        m_h1d["jet2_phi"]->Fill(j2->phi(), weight);
+        m_buffers[JET2_PT].fill(j2->pt() / 1000., weight);
+        m_buffers[JET2_ETA].fill(j2->eta(), weight);
+        m_buffers[JET2_PHI].fill(j2->phi(), weight);
     }
 }
 
 void HistogramsBook::fill_truth(const xAOD::TruthParticle* tau1, const xAOD::TruthParticle* tau2, const double& weight) {
     if (tau1 != NULL) {
-        m_h1d["truth_tau1_pt"]->Fill(tau1->auxdata<double>("pt_vis") / 1000., weight);
-        m_h1d["truth_tau1_eta"]->Fill(tau1->auxdata<double>("eta_vis"), weight);
-        m_h1d["truth_tau1_phi"]->Fill(tau1->auxdata<double>("phi_vis"), weight);
+        m_buffers[TRUTH_TAU1_PT].fill(s_pt_vis(*tau1) / 1000., weight);
+        m_buffers[TRUTH_TAU1_ETA].fill(s_eta_vis(*tau1), weight);
+        m_buffers[TRUTH_TAU1_PHI].fill(s_phi_vis(*tau1), weight);
     }
 
     if (tau2 != NULL) {
-        m_h1d["truth_tau2_pt"]->Fill(tau2->auxdata<double>("pt_vis") / 1000., weight);
-        m_h1d["truth_tau2_eta"]->Fill(tau2->auxdata<double>("eta_vis"), weight);
-        m_h1d["truth_tau2_phi"]->Fill(tau2->auxdata<double>("phi_vis"), weight);
+        m_buffers[TRUTH_TAU2_PT].fill(s_pt_vis(*tau2) / 1000., weight);
+        m_buffers[TRUTH_TAU2_ETA].fill(s_eta_vis(*tau2), weight);
+        m_buffers[TRUTH_TAU2_PHI].fill(s_phi_vis(*tau2), weight);
     }
 }
 
 void HistogramsBook::record(EL::Worker* wk) {
-    for (auto h : m_h1d) {
-        std::cout << h.second->GetName() << std::endl;
-        wk->addOutput(h.second);
+    for (int i = 0; i < N_HISTS; i++) {
+        std::cout << m_h1d[i]->GetName() << std::endl;
+        wk->addOutput(m_h1d[i]);
     }
 }
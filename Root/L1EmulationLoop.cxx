@@ -1,8 +1,13 @@
+#include <cmath>
+
 #include <EventLoop/Job.h>
+#include <EventLoop/OutputStream.h>
 #include <EventLoop/StatusCode.h>
 #include <EventLoop/Worker.h>
 #include <TriggerValidation/L1EmulationLoop.h>
 
+#include "TFile.h"
+
 #include "xAODRootAccess/Init.h"
 #include "xAODRootAccess/TEvent.h"
 #include "xAODRootAccess/tools/Message.h"
@@ -33,12 +38,21 @@
 // this is needed to distribute the algorithm to the workers
 ClassImp(L1EmulationLoop)
 
-    L1EmulationLoop::L1EmulationLoop() {}
+    L1EmulationLoop::L1EmulationLoop()
+    : print_mismatches(false), write_decisions(false), eb_livetime(0), m_rates(nullptr) {}
 
 EL::StatusCode L1EmulationLoop::setupJob(EL::Job& job) {
     job.useXAOD();
     EL_RETURN_CHECK("setupJob ()", xAOD::Init());
 
+    // side file of the events where the TDT and the emulation disagree
+    job.outputAdd(EL::OutputStream("l1_mismatches"));
+
+    // per-event decisions of all the items, on request
+    if (write_decisions) {
+        job.outputAdd(EL::OutputStream("l1_decisions"));
+    }
+
     return EL::StatusCode::SUCCESS;
 }
 
@@ -58,6 +72,39 @@ EL::StatusCode L1EmulationLoop::histInitialize() {
     wk()->addOutput(h_TDT_fires);
     wk()->addOutput(h_EMU_fires);
 
+    if (not eb_weights.empty()) {
+        const unsigned int n = l1_chains.size();
+        h_rate = new TH1D("h_rate", "emulated_rate", n, 0, n);
+        h_unique_rate = new TH1D("h_unique_rate", "emulated_unique_rate", n, 0, n);
+        h_overlap_rate = new TH2D("h_overlap_rate", "emulated_overlap_rate", n, 0, n, n, 0, n);
+        h_union_rate = new TH1D("h_union_rate", "emulated_union_rate", 1, 0, 1);
+        h_union_rate->GetXaxis()->SetBinLabel(1, "union");
+        for (unsigned int ich = 0; ich < n; ich++) {
+            const char* chain = l1_chains[ich].c_str();
+            h_rate->GetXaxis()->SetBinLabel(ich + 1, chain);
+            h_unique_rate->GetXaxis()->SetBinLabel(ich + 1, chain);
+            h_overlap_rate->GetXaxis()->SetBinLabel(ich + 1, chain);
+            h_overlap_rate->GetYaxis()->SetBinLabel(ich + 1, chain);
+        }
+        wk()->addOutput(h_rate);
+        wk()->addOutput(h_unique_rate);
+        wk()->addOutput(h_overlap_rate);
+        wk()->addOutput(h_union_rate);
+    }
+
+    std::vector<TH1*> sweep_hists;
+    if (not sweep_tau_thresholds.empty()) {
+        m_sweep.book(ThresholdSweep::TAU, sweep_tau_thresholds, sweep_hists);
+        m_sweep.book(ThresholdSweep::TAU_IM, sweep_tau_thresholds, sweep_hists);
+    }
+    if (not sweep_em_thresholds.empty()) {
+        m_sweep.book(ThresholdSweep::EM, sweep_em_thresholds, sweep_hists);
+    }
+    if (not sweep_jet_thresholds.empty()) {
+        m_sweep.book(ThresholdSweep::JET, sweep_jet_thresholds, sweep_hists);
+    }
+    for (auto h : sweep_hists) wk()->addOutput(h);
+
     return EL::StatusCode::SUCCESS;
 }
 
@@ -66,6 +113,9 @@ EL::StatusCode L1EmulationLoop::fileExecute() {
 }
 
 EL::StatusCode L1EmulationLoop::changeInput(bool /*firstFile*/) {
+    const std::string file = wk()->inputFile()->GetName();
+    m_replay.select(replay_files, replay_entries, file);
+    m_mismatches.setInput(file);
     return EL::StatusCode::SUCCESS;
 }
 
@@ -125,11 +175,44 @@ EL::StatusCode L1EmulationLoop::initialize() {
                  << " #(MET tools) = " << m_nEnergySumTools
             ); 
 
+    // the chain group handles follow the configuration changes by
+    // themselves. Which items exist is only known once the configuration of
+    // the first event is loaded, see updateChains()
+    m_chain_groups.clear();
+    for (auto it : l1_chains) {
+        m_chain_groups.push_back(m_trigDecisionTool->getChainGroup(it));
+    }
+    m_chain_exists.assign(l1_chains.size(), 0);
+    m_config_known = false;
+    m_tdt_passed.assign(l1_chains.size(), 0);
+    m_tdt_fired.assign(l1_chains.size(), 0);
+    m_emu_passed.assign(l1_chains.size(), 0);
+
+    m_mismatches.book(wk()->getOutputFile("l1_mismatches"), l1_chains);
+    if (not eb_weights.empty()) {
+        if (not m_eb_weights.read(eb_weights)) {
+            Error("initialize()", "Cannot read the EnhancedBias weights from %s", eb_weights.c_str());
+            return EL::StatusCode::FAILURE;
+        }
+        Info("initialize()", "%u EnhancedBias weights read from %s", m_eb_weights.size(), eb_weights.c_str());
+        m_rates = new RateAccumulator(l1_chains.size());
+        m_emu_bits.assign((l1_chains.size() + 63) / 64, 0);
+        m_n_unweighted = 0;
+    }
+
+    if (write_decisions) {
+        m_decisions.book(wk()->getOutputFile("l1_decisions"), l1_chains);
+    }
 
     return EL::StatusCode::SUCCESS;
 }
 
 EL::StatusCode L1EmulationLoop::execute() {
+    // in replay mode, skip the other entries before reading anything
+    if (not m_replay.contains(wk()->treeEntry())) {
+        return EL::StatusCode::SUCCESS;
+    }
+
     xAOD::TEvent* event = wk()->xaodEvent();
     MY_MSG_VERBOSE("--------------------------");
     MY_MSG_VERBOSE("Read event number " << wk()->treeEntry() << " / " << event->getEntries());
@@ -139,12 +222,12 @@ EL::StatusCode L1EmulationLoop::execute() {
     EL_RETURN_CHECK("execute", event->retrieve(ei, "EventInfo"));
 
     const xAOD::EmTauRoIContainer* l1taus = 0;
-    if(m_nEmTauTools > 0) {
+    if(m_nEmTauTools > 0 or m_sweep.needsEmTaus()) {
         EL_RETURN_CHECK("execute", event->retrieve(l1taus, "LVL1EmTauRoIs"));
     }
 
     const xAOD::JetRoIContainer* l1jets = 0;
-    if(m_nJetTools > 0) {
+    if(m_nJetTools > 0 or m_sweep.needsJets()) {
         EL_RETURN_CHECK("execute", event->retrieve(l1jets, "LVL1JetRoIs"));
     }
 
@@ -158,18 +241,61 @@ EL::StatusCode L1EmulationLoop::execute() {
         EL_RETURN_CHECK("execute", event->retrieve(l1xe, "LVL1EnergySumRoI"));
     }
 
+    // threshold sweep, on the RoIs sorted once per event
+    if (m_sweep.active()) {
+        m_sweep.fill(l1taus, l1jets);
+    }
+
     //ATH_MSG_INFO("Got: taus: " << l1taus << " jets " << l1jets << " muons " << l1muons << " xe " << l1xe);
 
     StatusCode code = m_l1_emulationTool->calculate(l1taus, l1jets, l1muons, l1xe);
     if (code == StatusCode::FAILURE) return EL::StatusCode::FAILURE;
 
-    bool at_least_one_diff = false;
+    // the menu can change between files and runs (e.g. EnhancedBias)
+    const unsigned int smk = m_trigConfigTool->masterKey();
+    const unsigned int l1psk = m_trigConfigTool->lvl1PrescaleKey();
+    if (not m_config_known or smk != m_smk or l1psk != m_l1psk) {
+        updateChains();
+        m_config_known = true;
+        m_smk = smk;
+        m_l1psk = l1psk;
+    }
+
+    // decisions of all the items, the TDT bits are read once per item
+    for (unsigned int ich = 0; ich < l1_chains.size(); ich++) {
+        m_emu_passed[ich] = m_l1_emulationTool->decision(l1_chains[ich]);
+
+        m_tdt_passed[ich] = 0;
+        m_tdt_fired[ich] = 0;
+        if (m_chain_exists[ich]) {
+            const unsigned int bits = m_chain_groups[ich]->isPassedBits();
+            m_tdt_passed[ich] = (bits & TrigDefs::L1_isPassedBeforePrescale) != 0;
+            m_tdt_fired[ich] = m_tdt_passed[ich] or (bits & TrigDefs::L1_isPassedAfterVeto) != 0;
+        }
+    }
+
+    if (write_decisions) {
+        m_decisions.fill(ei->runNumber(), ei->lumiBlock(), ei->eventNumber(), m_tdt_passed, m_emu_passed);
+    }
+
+    // rate mode: weighted sums over the emulated decisions
+    if (m_rates) {
+        double weight = 0;
+        if (m_eb_weights.weight(ei->runNumber(), ei->eventNumber(), weight)) {
+            DecisionBits::pack(m_emu_passed, m_emu_bits);
+            m_rates->fill(m_emu_bits, weight);
+        } else {
+            m_n_unweighted++;
+        }
+    }
+
+    m_mismatches.clear(wk()->treeEntry(), ei->runNumber(), ei->eventNumber(), ei->lumiBlock());
     std::vector<std::string> decision_lines;
-    for (auto it : l1_chains) {
-        // emulation decision
-        bool emul_passes_event = m_l1_emulationTool->decision(it);
+    for (unsigned int ich = 0; ich < l1_chains.size(); ich++) {
+        const std::string& it = l1_chains[ich];
+        bool emul_passes_event = m_emu_passed[ich];
 
-        if (m_l1_emulationTool->decision(it)) {
+        if (print_mismatches and emul_passes_event) {
             const auto type = m_l1_emulationTool->getTopoType(it);
             if (type != "") {
                 std::cout << type << std::endl;
@@ -198,28 +324,22 @@ EL::StatusCode L1EmulationLoop::execute() {
         }
 
         // TDT decision
-        bool cg_passes_event = false;
-        bool cg_passes_event_1 = false;
-        if(m_trigDecisionTool->getListOfTriggers(it).size() == 0) {
-            ATH_MSG_DEBUG("Chain " << it << " doesn't exist in TDT!");
-        } else {
-            ATH_MSG_INFO("size = " << m_trigDecisionTool->getListOfTriggers(it).size());
-            auto chain_group = m_trigDecisionTool->getChainGroup(it);
-            cg_passes_event = chain_group->isPassedBits() & TrigDefs::L1_isPassedBeforePrescale;
-            cg_passes_event_1 = chain_group->isPassedBits() & TrigDefs::L1_isPassedAfterVeto;
-        }
+        bool cg_passes_event = m_tdt_passed[ich];
 
-        if (cg_passes_event or cg_passes_event_1) {
-            h_TDT_fires->Fill(it.c_str(), 1);
+        if (m_tdt_fired[ich]) {
+            h_TDT_fires->Fill(ich);
         }
 
         if (emul_passes_event) {
-            h_EMU_fires->Fill(it.c_str(), 1);
+            h_EMU_fires->Fill(ich);
         }
 
         if (emul_passes_event != cg_passes_event) {
-            at_least_one_diff = true;
-            h_TDT_EMU_diff->Fill(it.c_str(), 1);
+            h_TDT_EMU_diff->Fill(ich);
+            m_mismatches.addChain(ich, cg_passes_event, emul_passes_event);
+            if (not print_mismatches) {
+                continue;
+            }
             std::ostringstream decision_line;
             decision_line << "\t |" << std::setw(43) << it;
             decision_line << " |  " << std::setw(5) << cg_passes_event;
@@ -228,8 +348,26 @@ EL::StatusCode L1EmulationLoop::execute() {
             decision_lines.push_back(decision_line.str());
         }
     }
-    // print-outs
-    if (at_least_one_diff) {
+    // record the disagreements with the RoIs, print them on request
+    if (m_mismatches.size() > 0) {
+        if (l1taus) {
+            m_mismatches.addEmTauRoIs(*l1taus);
+        }
+        if (l1jets) {
+            m_mismatches.addObjects(MismatchRecorder::L1_JET, *l1jets, [](const xAOD::JetRoI* r) { return r->et8x8(); });
+        }
+        if (l1muons) {
+            m_mismatches.addObjects(MismatchRecorder::L1_MUON, *l1muons, [](const xAOD::MuonRoI* r) { return r->thrValue(); });
+        }
+        if (l1xe) {
+            // missing transverse energy, from the components stored in the RoI
+            m_mismatches.addObject(MismatchRecorder::L1_XE, std::hypot(l1xe->energyX(), l1xe->energyY()), 0.,
+                                   std::atan2(l1xe->energyY(), l1xe->energyX()));
+        }
+        m_mismatches.write();
+    }
+
+    if (print_mismatches and m_mismatches.size() > 0) {
         Warning("execute", "event number %d -- lumi block %d", (int)ei->eventNumber(), (int)ei->lumiBlock());
         EL_RETURN_CHECK("execute", m_l1_emulationTool->PrintReport(l1taus, l1jets, l1muons, l1xe));
         // EL_RETURN_CHECK("execute", m_l1_emulationTool->PrintCounters());
@@ -260,6 +398,16 @@ EL::StatusCode L1EmulationLoop::execute() {
     return EL::StatusCode::SUCCESS;
 }
 
+void L1EmulationLoop::updateChains() {
+    for (unsigned int ich = 0; ich < l1_chains.size(); ich++) {
+        const std::string& it = l1_chains[ich];
+        m_chain_exists[ich] = m_chain_groups[ich]->getListOfTriggers().size() != 0;
+        if (not m_chain_exists[ich]) {
+            ATH_MSG_INFO("Chain " << it << " doesn't exist in TDT!");
+        }
+    }
+}
+
 EL::StatusCode L1EmulationLoop::postExecute() {
     // Here you do everything that needs to be done after the main event
     // processing.  This is typically very rare, particularly in user
@@ -268,6 +416,14 @@ EL::StatusCode L1EmulationLoop::postExecute() {
 }
 
 EL::StatusCode L1EmulationLoop::finalize() {
+    if (m_rates) {
+        m_rates->write(h_rate, h_unique_rate, h_overlap_rate, h_union_rate, eb_livetime);
+        Info("finalize()", "rates from %.1f weighted events, %lu events without EnhancedBias weight", m_rates->events(),
+             m_n_unweighted);
+        delete m_rates;
+        m_rates = nullptr;
+    }
+
     if (m_trigConfigTool) {
         m_trigConfigTool = nullptr;
         delete m_trigConfigTool;
@@ -291,5 +447,8 @@ EL::StatusCode L1EmulationLoop::finalize() {
 }
 
 EL::StatusCode L1EmulationLoop::histFinalize() {
+    // the sweep only counts events, fill its histograms now
+    m_sweep.finalize();
+
     return EL::StatusCode::SUCCESS;
 }
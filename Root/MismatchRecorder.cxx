@@ -0,0 +1,131 @@
+#include "TriggerValidation/MismatchRecorder.h"
+
+#include "TList.h"
+#include "TObjString.h"
+
+MismatchRecorder::MismatchRecorder()
+    : m_entry(0),
+      m_run(0),
+      m_event(0),
+      m_lumiblock(0),
+      m_tree(nullptr),
+      m_file_ptr(&m_file),
+      m_chain_ptr(&m_chain),
+      m_tdt_ptr(&m_tdt),
+      m_emulation_ptr(&m_emulation),
+      m_kind_ptr(&m_kind),
+      m_pt_ptr(&m_pt),
+      m_eta_ptr(&m_eta),
+      m_phi_ptr(&m_phi) {}
+
+void MismatchRecorder::book(TDirectory* dir, const std::vector<std::string>& chains) {
+    m_chains = chains;
+
+    m_tree = new TTree("mismatches", "TDT and emulation disagreements");
+    m_tree->SetDirectory(dir);
+    for (auto& chain : m_chains) m_tree->GetUserInfo()->Add(new TObjString(chain.c_str()));
+
+    m_tree->Branch("file", &m_file);
+    m_tree->Branch("entry", &m_entry);
+    m_tree->Branch("run", &m_run);
+    m_tree->Branch("event", &m_event);
+    m_tree->Branch("lumiblock", &m_lumiblock);
+    m_tree->Branch("chain", &m_chain);
+    m_tree->Branch("tdt", &m_tdt);
+    m_tree->Branch("emulation", &m_emulation);
+    m_tree->Branch("kind", &m_kind);
+    m_tree->Branch("pt", &m_pt);
+    m_tree->Branch("eta", &m_eta);
+    m_tree->Branch("phi", &m_phi);
+}
+
+bool MismatchRecorder::attach(TTree* tree) {
+    m_tree = tree;
+
+    m_chains.clear();
+    TIter next(m_tree->GetUserInfo());
+    while (TObject* obj = next()) m_chains.push_back(obj->GetName());
+
+    const char* names[] = {"file", "entry", "run", "event", "lumiblock", "chain",
+                           "tdt", "emulation", "kind", "pt", "eta", "phi"};
+    for (auto name : names) {
+        if (not m_tree->GetBranch(name)) return false;
+    }
+
+    m_tree->SetBranchAddress("file", &m_file_ptr);
+    m_tree->SetBranchAddress("entry", &m_entry);
+    m_tree->SetBranchAddress("run", &m_run);
+    m_tree->SetBranchAddress("event", &m_event);
+    m_tree->SetBranchAddress("lumiblock", &m_lumiblock);
+    m_tree->SetBranchAddress("chain", &m_chain_ptr);
+    m_tree->SetBranchAddress("tdt", &m_tdt_ptr);
+    m_tree->SetBranchAddress("emulation", &m_emulation_ptr);
+    m_tree->SetBranchAddress("kind", &m_kind_ptr);
+    m_tree->SetBranchAddress("pt", &m_pt_ptr);
+    m_tree->SetBranchAddress("eta", &m_eta_ptr);
+    m_tree->SetBranchAddress("phi", &m_phi_ptr);
+    return true;
+}
+
+void MismatchRecorder::clear(Long64_t entry, unsigned int run, unsigned long long event, unsigned int lumiblock) {
+    m_entry = entry;
+    m_run = run;
+    m_event = event;
+    m_lumiblock = lumiblock;
+
+    m_chain.clear();
+    m_tdt.clear();
+    m_emulation.clear();
+
+    m_kind.clear();
+    m_pt.clear();
+    m_eta.clear();
+    m_phi.clear();
+}
+
+void MismatchRecorder::addChain(unsigned int index, bool tdt, bool emulation) {
+    m_chain.push_back(index);
+    m_tdt.push_back(tdt);
+    m_emulation.push_back(emulation);
+}
+
+void MismatchRecorder::addObject(Kind kind, float pt, float eta, float phi) {
+    m_kind.push_back(kind);
+    m_pt.push_back(pt);
+    m_eta.push_back(eta);
+    m_phi.push_back(phi);
+}
+
+void MismatchRecorder::addEmTauRoIs(const xAOD::EmTauRoIContainer& rois) {
+    for (auto roi : rois) {
+        if (roi->roiType() == xAOD::EmTauRoI::TauRoIWord)
+            addObject(L1_TAU, roi->tauClus(), roi->eta(), roi->phi());
+        else
+            addObject(L1_EM, roi->emClus(), roi->eta(), roi->phi());
+    }
+}
+
+void MismatchRecorder::write() {
+    if (m_tree and not m_chain.empty()) m_tree->Fill();
+}
+
+const char* MismatchRecorder::kindName(Kind kind) {
+    switch (kind) {
+        case L1_TAU:
+            return "L1_TAU";
+        case L1_EM:
+            return "L1_EM";
+        case L1_JET:
+            return "L1_JET";
+        case L1_MUON:
+            return "L1_MUON";
+        case L1_XE:
+            return "L1_XE";
+        case HLT_TAU:
+            return "HLT_TAU";
+        case HLT_CALO_ONLY_TAU:
+            return "HLT_CALO_ONLY_TAU";
+        default:
+            return "UNKNOWN";
+    }
+}
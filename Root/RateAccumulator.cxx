@@ -0,0 +1,90 @@
+#include "TriggerValidation/RateAccumulator.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+bool EnhancedBiasWeights::read(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (not in) return false;
+
+    m_weights.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        std::istringstream fields(line);
+        Key key;
+        double w;
+        if (not(fields >> key.run >> key.event >> w)) return false;
+        m_weights[key] = w;
+    }
+    return true;
+}
+
+bool EnhancedBiasWeights::weight(unsigned int run, unsigned long long event, double& w) const {
+    Key key;
+    key.run = run;
+    key.event = event;
+    auto it = m_weights.find(key);
+    if (it == m_weights.end()) return false;
+    w = it->second;
+    return true;
+}
+
+RateAccumulator::RateAccumulator(unsigned int nitems)
+    : m_nitems(nitems),
+      m_events(0),
+      m_union(0),
+      m_union2(0),
+      m_pass(nitems, 0),
+      m_pass2(nitems, 0),
+      m_unique(nitems, 0),
+      m_unique2(nitems, 0),
+      m_overlap(nitems * nitems, 0),
+      m_overlap2(nitems * nitems, 0) {}
+
+void RateAccumulator::fill(const std::vector<ULong64_t>& bits, double w) {
+    const double w2 = w * w;
+    m_events += w;
+
+    m_fired.clear();
+    for (unsigned int iw = 0; iw < bits.size(); iw++) {
+        for (ULong64_t word = bits[iw]; word; word &= word - 1) m_fired.push_back(iw * 64 + __builtin_ctzll(word));
+    }
+    if (m_fired.empty()) return;
+
+    m_union += w;
+    m_union2 += w2;
+    if (m_fired.size() == 1) {
+        m_unique[m_fired[0]] += w;
+        m_unique2[m_fired[0]] += w2;
+    }
+
+    for (unsigned int i : m_fired) {
+        m_pass[i] += w;
+        m_pass2[i] += w2;
+        for (unsigned int j : m_fired) {
+            m_overlap[i * m_nitems + j] += w;
+            m_overlap2[i * m_nitems + j] += w2;
+        }
+    }
+}
+
+void RateAccumulator::write(TH1D* h_pass, TH1D* h_unique, TH2D* h_overlap, TH1D* h_union, double livetime) const {
+    const double scale = livetime > 0 ? 1. / livetime : 1.;
+
+    for (unsigned int i = 0; i < m_nitems; i++) {
+        h_pass->SetBinContent(i + 1, m_pass[i] * scale);
+        h_pass->SetBinError(i + 1, std::sqrt(m_pass2[i]) * scale);
+        h_unique->SetBinContent(i + 1, m_unique[i] * scale);
+        h_unique->SetBinError(i + 1, std::sqrt(m_unique2[i]) * scale);
+        for (unsigned int j = 0; j < m_nitems; j++) {
+            h_overlap->SetBinContent(i + 1, j + 1, m_overlap[i * m_nitems + j] * scale);
+            h_overlap->SetBinError(i + 1, j + 1, std::sqrt(m_overlap2[i * m_nitems + j]) * scale);
+        }
+    }
+    h_union->SetBinContent(1, m_union * scale);
+    h_union->SetBinError(1, std::sqrt(m_union2) * scale);
+}
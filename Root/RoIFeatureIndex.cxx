@@ -0,0 +1,60 @@
+#include "TriggerValidation/RoIFeatureIndex.h"
+
+#include <algorithm>
+
+void RoIFeatureIndex::clear() {
+    for (unsigned int i = 0; i < m_nrois * N_KINDS; i++) m_features[i].clear();
+    m_roi_slots.clear();
+    m_nrois = 0;
+}
+
+void RoIFeatureIndex::roiNodes(const HLT::TriggerElement* te) {
+    m_nodes.clear();
+    if (not te) return;
+
+    if (HLT::TrigNavStructure::isRoINode(te)) {
+        m_nodes.push_back(te);
+    } else {
+        for (const HLT::TriggerElement* roi : HLT::TrigNavStructure::getRoINodes(te)) m_nodes.push_back(roi);
+    }
+}
+
+void RoIFeatureIndex::add(Kind kind, unsigned int feature, const HLT::TriggerElement* te) {
+    roiNodes(te);
+    for (const HLT::TriggerElement* roi : m_nodes) {
+        auto slot = m_roi_slots.insert(std::make_pair(roi, m_nrois));
+        if (slot.second) {
+            m_nrois++;
+            if (m_features.size() < m_nrois * N_KINDS) m_features.resize(m_nrois * N_KINDS);
+        }
+
+        // a feature under several RoIs is filed once per RoI, the features
+        // are added in increasing order so the last entry is enough
+        std::vector<unsigned int>& features = m_features[slot.first->second * N_KINDS + kind];
+        if (features.empty() or features.back() != feature) features.push_back(feature);
+    }
+}
+
+void RoIFeatureIndex::find(const HLT::TriggerElement* te) {
+    for (int kind = 0; kind < N_KINDS; kind++) m_found[kind].clear();
+
+    roiNodes(te);
+    for (const HLT::TriggerElement* roi : m_nodes) {
+        auto slot = m_roi_slots.find(roi);
+        if (slot == m_roi_slots.end()) continue;
+
+        for (int kind = 0; kind < N_KINDS; kind++) {
+            const std::vector<unsigned int>& features = m_features[slot->second * N_KINDS + kind];
+            m_found[kind].insert(m_found[kind].end(), features.begin(), features.end());
+        }
+    }
+
+    // only sort and deduplicate when te sits under more than one RoI
+    if (m_nodes.size() > 1) {
+        for (int kind = 0; kind < N_KINDS; kind++) {
+            std::vector<unsigned int>& found = m_found[kind];
+            std::sort(found.begin(), found.end());
+            found.erase(std::unique(found.begin(), found.end()), found.end());
+        }
+    }
+}
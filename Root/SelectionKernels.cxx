@@ -0,0 +1,69 @@
+#include "TriggerValidation/SelectionKernels.h"
+
+#include <cmath>
+
+void TauSnapshot::fill(const xAOD::TauJetContainer& taus) {
+    const unsigned int n = taus.size();
+    m_pt.resize(n);
+    m_eta.resize(n);
+    m_ntracks.resize(n);
+    m_medium.resize(n);
+
+    for (unsigned int i = 0; i < n; i++) {
+        const xAOD::TauJet* tau = taus[i];
+        m_pt[i] = tau->pt();
+        m_eta[i] = tau->eta();
+        m_ntracks[i] = tau->nTracks();
+        m_medium[i] = tau->isTau(xAOD::TauJetParameters::JetBDTSigMedium);
+    }
+}
+
+unsigned int TauSnapshot::select(const TauCuts& cuts, std::vector<char>& mask) const {
+    const unsigned int n = m_pt.size();
+    const char skip_id = not cuts.medium_id;
+    mask.resize(n);
+
+    // the comparisons are written as negated rejections to keep the exact
+    // behaviour of the cuts, NaN included
+    unsigned int n_passed = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        const double pt = m_pt[i];
+        const double abs_eta = std::fabs((double)m_eta[i]);
+        const int ntracks = m_ntracks[i];
+
+        const char pass = (not(pt < cuts.min_pt)) & (not(abs_eta > cuts.max_eta)) &
+                          (not((abs_eta > cuts.crack_low) & (abs_eta < cuts.crack_high))) & ((ntracks == 1) | (ntracks == 3)) &
+                          (m_medium[i] | skip_id);
+        mask[i] = pass;
+        n_passed += pass;
+    }
+    return n_passed;
+}
+
+void JetSnapshot::fill(const xAOD::JetContainer& jets) {
+    const unsigned int n = jets.size();
+    m_pt.resize(n);
+    m_eta.resize(n);
+
+    for (unsigned int i = 0; i < n; i++) {
+        const xAOD::Jet* jet = jets[i];
+        m_pt[i] = jet->pt();
+        m_eta[i] = jet->eta();
+    }
+}
+
+unsigned int JetSnapshot::select(const JetCuts& cuts, std::vector<char>& mask) const {
+    const unsigned int n = m_pt.size();
+    mask.resize(n);
+
+    unsigned int n_passed = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        const double pt = m_pt[i];
+        const double abs_eta = std::fabs((double)m_eta[i]);
+
+        const char pass = (not(pt < cuts.min_pt)) & (not(abs_eta > cuts.max_eta));
+        mask[i] = pass;
+        n_passed += pass;
+    }
+    return n_passed;
+}
@@ -0,0 +1,120 @@
+#include "TriggerValidation/ThresholdScan.h"
+
+#include <algorithm>
+
+ThresholdScan::ThresholdScan() : m_symmetric(NULL), m_map(NULL) {}
+
+void ThresholdScan::setup(const std::vector<double>& lead_thresholds, const std::vector<double>& sublead_thresholds,
+                          TH1F* h_symmetric, const std::vector<std::string>& symmetric_labels, TH2F* h_map,
+                          const std::vector<std::string>& lead_labels, const std::vector<std::string>& sublead_labels) {
+    m_lead = lead_thresholds;
+    m_sublead = sublead_thresholds;
+
+    m_symmetric = h_symmetric;
+    m_map = h_map;
+
+    m_symmetric_labels = symmetric_labels;
+    m_lead_labels = lead_labels;
+    m_sublead_labels = sublead_labels;
+
+    m_symmetric_counts.assign(m_sublead.size() + 1, 0);
+    m_map_counts.assign((m_lead.size() + 1) * (m_sublead.size() + 1), 0);
+}
+
+void ThresholdScan::fill(double lead, double sublead) {
+    // number of passed thresholds for each object
+    const unsigned int n_lead = passed(m_lead, lead);
+    const unsigned int n_sublead = passed(m_sublead, sublead);
+    const unsigned int n_lead_sym = passed(m_sublead, lead);
+
+    m_symmetric_counts[std::min(n_lead_sym, n_sublead)] += 1;
+    m_map_counts[n_lead * (m_sublead.size() + 1) + n_sublead] += 1;
+}
+
+void ThresholdScan::finalize() {
+    const int n_lead = m_lead.size();
+    const int n_sublead = m_sublead.size();
+
+    if (m_symmetric != NULL) {
+        // the labels missing from the axis are added in increasing threshold
+        // order, as the per-event fills did (e.g. 2tau<tau2 threshold> when
+        // the axis carries the tau1 thresholds)
+        unsigned long cumulative = 0;
+        for (int i = 0; i < n_sublead; i++) {
+            cumulative += m_symmetric_counts[i + 1];
+        }
+        for (int i = 0; i < n_sublead; i++) {
+            if (cumulative == 0) break;
+            addLabel(m_symmetric->GetXaxis(), m_symmetric_labels[i]);
+            cumulative -= m_symmetric_counts[i + 1];
+        }
+
+        // bin i counts the events with more than i passed thresholds; only
+        // unit weight contents, no Sumw2
+        cumulative = 0;
+        for (int i = n_sublead - 1; i >= 0; i--) {
+            cumulative += m_symmetric_counts[i + 1];
+            if (cumulative == 0) continue;
+
+            int bin = findLabel(m_symmetric->GetXaxis(), m_symmetric_labels[i]);
+            if (bin > 0) m_symmetric->AddBinContent(bin, cumulative);
+        }
+        m_symmetric->ResetStats();
+    }
+
+    if (m_map != NULL) {
+        // suffix sums: sum[a][b] = number of events with at least a leading
+        // and b subleading passed thresholds
+        const int stride = n_sublead + 2;
+        std::vector<unsigned long> sum((n_lead + 2) * stride, 0);
+        for (int a = n_lead; a >= 0; a--) {
+            for (int b = n_sublead; b >= 0; b--) {
+                sum[a * stride + b] = m_map_counts[a * (n_sublead + 1) + b] + sum[(a + 1) * stride + b] +
+                                      sum[a * stride + b + 1] - sum[(a + 1) * stride + b + 1];
+            }
+        }
+
+        // missing labels first, in increasing threshold order
+        for (int i = 0; i < n_sublead; i++) {
+            for (int j = i; j < n_lead; j++) {
+                if (sum[(j + 1) * stride + i + 1] == 0) continue;
+                addLabel(m_map->GetXaxis(), m_lead_labels[j]);
+                addLabel(m_map->GetYaxis(), m_sublead_labels[i]);
+            }
+        }
+
+        for (int i = 0; i < n_sublead; i++) {
+            for (int j = i; j < n_lead; j++) {
+                unsigned long content = sum[(j + 1) * stride + i + 1];
+                if (content == 0) continue;
+
+                int binx = findLabel(m_map->GetXaxis(), m_lead_labels[j]);
+                int biny = findLabel(m_map->GetYaxis(), m_sublead_labels[i]);
+                if (binx > 0 and biny > 0) m_map->AddBinContent(m_map->GetBin(binx, biny), content);
+            }
+        }
+        m_map->ResetStats();
+    }
+
+    // make sure a second call does not double count
+    std::fill(m_symmetric_counts.begin(), m_symmetric_counts.end(), 0);
+    std::fill(m_map_counts.begin(), m_map_counts.end(), 0);
+}
+
+unsigned int ThresholdScan::passed(const std::vector<double>& thresholds, double value) {
+    return std::upper_bound(thresholds.begin(), thresholds.end(), value) - thresholds.begin();
+}
+
+void ThresholdScan::addLabel(TAxis* axis, const std::string& label) {
+    // TAxis::FindBin(label) extends an alphanumeric axis with a missing
+    // label, as a fill by label does
+    if (findLabel(axis, label) < 0) axis->FindBin(label.c_str());
+}
+
+int ThresholdScan::findLabel(const TAxis* axis, const std::string& label) {
+    // same as filling by label: the first bin carrying the label
+    for (int bin = 1; bin <= axis->GetNbins(); bin++) {
+        if (label == axis->GetBinLabel(bin)) return bin;
+    }
+    return -1;
+}
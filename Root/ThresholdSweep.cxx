@@ -0,0 +1,149 @@
+#include "TriggerValidation/ThresholdSweep.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "TString.h"
+
+namespace {
+    // TAU IM isolation, in MeV
+    const double ISOL_OFFSET = 2000.;
+    const double ISOL_SLOPE = 0.1;
+    const double ISOL_MAX_ET = 60000.;
+}
+
+ThresholdSweep::ThresholdSweep() {
+    for (int family = 0; family < N_FAMILIES; family++) m_active[family] = false;
+}
+
+std::string ThresholdSweep::name(Family family) {
+    switch (family) {
+        case TAU:
+            return "TAU";
+        case TAU_IM:
+            return "TAU_IM";
+        case EM:
+            return "EM";
+        case JET:
+            return "J";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+bool ThresholdSweep::isolated(const xAOD::EmTauRoI* roi) {
+    if (roi->tauClus() >= ISOL_MAX_ET) return true;
+    return roi->emIsol() <= ISOL_OFFSET + ISOL_SLOPE * roi->tauClus();
+}
+
+void ThresholdSweep::book(Family family, const std::vector<int>& thresholds, std::vector<TH1*>& hists) {
+    const std::string family_name = name(family);
+    const std::string item = family == TAU_IM ? "TAU" : family_name;
+    const std::string suffix = family == TAU_IM ? "IM" : "";
+    const int n = thresholds.size();
+
+    const char* fname = family_name.c_str();
+    TH1F* h_single = new TH1F(Form("h_sweep_%s_single", fname), Form("%s_single", fname), n, 0, n);
+    TH1F* h_pair = new TH1F(Form("h_sweep_%s_pair", fname), Form("%s_pair", fname), n, 0, n);
+    TH2F* h_map = new TH2F(Form("h_sweep_%s_map", fname), Form("%s_map", fname), n, 0, n, n, 0, n);
+
+    std::vector<double> mev;
+    std::vector<std::string> single_labels;
+    std::vector<std::string> pair_labels;
+    for (int i = 0; i < n; i++) {
+        single_labels.push_back(Form("%s%d%s", item.c_str(), thresholds[i], suffix.c_str()));
+        pair_labels.push_back(Form("2%s%d%s", item.c_str(), thresholds[i], suffix.c_str()));
+        mev.push_back(1000. * thresholds[i]);
+
+        h_single->GetXaxis()->SetBinLabel(i + 1, single_labels[i].c_str());
+        h_pair->GetXaxis()->SetBinLabel(i + 1, pair_labels[i].c_str());
+        h_map->GetXaxis()->SetBinLabel(i + 1, single_labels[i].c_str());
+        h_map->GetYaxis()->SetBinLabel(i + 1, pair_labels[i].c_str());
+    }
+
+    // single: the leading RoI is given as both objects of the pair
+    m_single[family].setup(mev, mev, h_single, single_labels, NULL, single_labels, single_labels);
+    m_pair[family].setup(mev, mev, h_pair, pair_labels, h_map, single_labels, pair_labels);
+    m_active[family] = true;
+
+    hists.push_back(h_single);
+    hists.push_back(h_pair);
+    hists.push_back(h_map);
+}
+
+bool ThresholdSweep::active() const {
+    for (int family = 0; family < N_FAMILIES; family++) {
+        if (m_active[family]) return true;
+    }
+    return false;
+}
+
+bool ThresholdSweep::needsEmTaus() const {
+    return m_active[TAU] or m_active[TAU_IM] or m_active[EM];
+}
+
+bool ThresholdSweep::needsJets() const {
+    return m_active[JET];
+}
+
+void ThresholdSweep::fillFamily(Family family, const std::vector<float>& et, const std::vector<char>* mask) {
+    // et is sorted: the first two RoIs passing the mask
+    float lead = 0;
+    float sublead = 0;
+    unsigned int found = 0;
+    for (unsigned int i = 0; i < et.size() and found < 2; i++) {
+        if (mask and not(*mask)[i]) continue;
+        if (found == 0)
+            lead = et[i];
+        else
+            sublead = et[i];
+        found++;
+    }
+
+    m_single[family].fill(lead, lead);
+    m_pair[family].fill(lead, sublead);
+}
+
+void ThresholdSweep::fill(const xAOD::EmTauRoIContainer* emtaus, const xAOD::JetRoIContainer* jets) {
+    if (emtaus and (m_active[TAU] or m_active[TAU_IM])) {
+        m_sorted.clear();
+        for (auto roi : *emtaus) {
+            if (roi->roiType() != xAOD::EmTauRoI::TauRoIWord) continue;
+            m_sorted.push_back(std::make_pair(roi->tauClus(), (char)isolated(roi)));
+        }
+        std::sort(m_sorted.begin(), m_sorted.end(), std::greater<std::pair<float, char> >());
+
+        m_et.clear();
+        m_isolated.clear();
+        for (auto& roi : m_sorted) {
+            m_et.push_back(roi.first);
+            m_isolated.push_back(roi.second);
+        }
+        if (m_active[TAU]) fillFamily(TAU, m_et, NULL);
+        if (m_active[TAU_IM]) fillFamily(TAU_IM, m_et, &m_isolated);
+    }
+
+    if (emtaus and m_active[EM]) {
+        m_et.clear();
+        for (auto roi : *emtaus) {
+            if (roi->roiType() == xAOD::EmTauRoI::EMRoIWord) m_et.push_back(roi->emClus());
+        }
+        std::sort(m_et.begin(), m_et.end(), std::greater<float>());
+        fillFamily(EM, m_et, NULL);
+    }
+
+    if (jets and m_active[JET]) {
+        m_et.clear();
+        for (auto roi : *jets) m_et.push_back(roi->et8x8());
+        std::sort(m_et.begin(), m_et.end(), std::greater<float>());
+        fillFamily(JET, m_et, NULL);
+    }
+}
+
+void ThresholdSweep::finalize() {
+    for (int family = 0; family < N_FAMILIES; family++) {
+        if (not m_active[family]) continue;
+        m_single[family].finalize();
+        m_pair[family].finalize();
+    }
+}
@@ -2,6 +2,7 @@
 #define TriggerValidation_AcceptanceHadHadTDR_H
 
 #include <EventLoop/Algorithm.h>
+#include "AthContainers/ConstDataVector.h"
 #include "xAODJet/JetContainer.h"
 #include "xAODTau/TauJetContainer.h"
 #include "xAODTrigger/EmTauRoIContainer.h"
@@ -12,7 +13,10 @@
 #include "TrigDecisionTool/TrigDecisionTool.h"
 
 // Local stuff
-#include "TriggerValidation/HistogramsBook.h"
+#include "TriggerValidation/CutConfig.h"
+#include "TriggerValidation/DeltaRMatcher.h"
+#include "TriggerValidation/EventArena.h"
+#include "TriggerValidation/SelectionKernels.h"
 
 #include <map>
 #include "TEfficiency.h"
@@ -23,7 +27,19 @@ class AcceptanceHadHadTDR : public EL::Algorithm {
     // put your configuration variables here as public variables.
     // that way they can be set directly from CINT and python.
   private:
-    HistogramsBook m_book;
+    std::vector<CutConfig> m_configs;  //!
+    std::vector<CutConfig *> m_passed;  //!
+    EventArena m_arena;                 //!
+    DeltaRMatcher m_tau_matcher;        //!
+    TauSnapshot m_tau_snapshot;         //!
+    JetSnapshot m_jet_snapshot;         //!
+    std::vector<char> m_mask;           //!
+    std::vector<const xAOD::TauJet *> m_lead_taus;       //!
+    std::vector<const xAOD::Jet *> m_lead_jets;          //!
+    std::vector<const xAOD::EmTauRoI *> m_lead_l1taus;  //!
+
+    CutConfig makeConfig(const std::string &name) const;
+    void bookConfig(CutConfig &config);
 
   public:
     // float cutValue;
@@ -51,16 +67,32 @@ class AcceptanceHadHadTDR : public EL::Algorithm {
 
     std::vector<std::string> triggers;
 
+    // additional cut configurations evaluated on the same events, one
+    // "name key=value key=value ..." entry per configuration (see CutConfig).
+    // The cuts that are not set take the values above.
+    std::vector<std::string> cut_configs;
+
+    // deep copy the selected objects into the store
+    // (SelectedTaus, SelectedJets and SelectedL1Taus)
+    bool record_selections;
+
+    // number of entries buffered before the kinematics histograms are filled
+    int fill_buffer_size;
+
     // variables that don't get filled at submission time should be
     // protected from being send from the submission node to the worker
     // node (done by the //!)
   public:
     // Tree *myTree; //!
     // TH1 *myHist; //!
+    // histograms of the default configuration
     TH2F *map_l1;      //!
     TH2F *map_off;     //!
     TH2F *map_l1taus;  //!
 
+    // number of events and of reads per input container
+    TH1F *h_container_reads;  //!
+
     std::map<std::string, TH1F *> hists;  //!
 
     Trig::TrigDecisionTool *m_trigDecisionTool;      //!
@@ -81,13 +113,16 @@ class AcceptanceHadHadTDR : public EL::Algorithm {
     virtual EL::StatusCode finalize();
     virtual EL::StatusCode histFinalize();
 
-    virtual EL::StatusCode select_taus(xAOD::TauJetContainer *selected_taus, const xAOD::TauJetContainer *taus);
-    virtual EL::StatusCode select_jets(xAOD::JetContainer *selected_jets, const xAOD::JetContainer *jets,
+    // the selections are views (SG::VIEW_ELEMENTS) over the input containers
+    virtual EL::StatusCode select_taus(ConstDataVector<xAOD::TauJetContainer> *selected_taus,
+                                       const xAOD::TauJetContainer *taus);
+    virtual EL::StatusCode select_jets(ConstDataVector<xAOD::JetContainer> *selected_jets, const xAOD::JetContainer *jets,
                                        const xAOD::TauJet *tau1, const xAOD::TauJet *tau2);
-    virtual EL::StatusCode select_l1taus(xAOD::EmTauRoIContainer *selected_l1taus, const xAOD::EmTauRoIContainer *l1taus);
+    virtual EL::StatusCode select_l1taus(ConstDataVector<xAOD::EmTauRoIContainer> *selected_l1taus,
+                                         const xAOD::EmTauRoIContainer *l1taus);
 
     // this is needed to distribute the algorithm to the workers
-    ClassDef(AcceptanceHadHadTDR, 1);
+    ClassDef(AcceptanceHadHadTDR, 4);
 };
 
 #endif
@@ -0,0 +1,406 @@
+#ifndef TRIGGERVALIDATION_ACCEPTANCESELECTIONS_H
+#define TRIGGERVALIDATION_ACCEPTANCESELECTIONS_H
+
+#include <string>
+#include <vector>
+
+#include <TDirectory.h>
+#include <TH1.h>
+
+#include "xAODEgamma/ElectronContainer.h"
+#include "xAODJet/JetContainer.h"
+#include "xAODMuon/MuonContainer.h"
+#include "xAODTau/TauJetContainer.h"
+
+#include "AssociationUtils/OverlapRemovalTool.h"
+#include "MuonSelectorTools/MuonSelectionTool.h"
+#include "TauAnalysisTools/TauSelectionTool.h"
+#include "TauAnalysisTools/TauTruthMatchingTool.h"
+#include "TrigDecisionTool/TrigDecisionTool.h"
+#include "TrigTauMatching/TrigTauMatching.h"
+
+#include "TriggerValidation/DecisionCache.h"
+#include "TriggerValidation/EffCurvesTool.h"
+#include "TriggerValidation/EventArena.h"
+#include "TriggerValidation/SelectionKernels.h"
+#include "TriggerValidation/Utils.h"
+
+// The hadhad and lephad selections of the acceptance executables, shared by
+// acceptance_hh, acceptance_lh and acceptance_combined. Like Utils.h, this
+// header is only meant for the executables in util/.
+
+// The acceptance of a list of triggers in one channel: the per-event
+// decision cache, the efficiency curves and the h_acceptance counts.
+//
+// Each trigger has three stages (nopt, nodr, final), one curve slot per
+// trigger and stage: slot = stage * ntrig + trigger index.
+class AcceptanceChannel {
+  public:
+    AcceptanceChannel(const std::string& name, const std::vector<std::string>& triggers)
+        : name(name),
+          triggers(triggers),
+          decisions(triggers.size()),
+          curves(slotNames(triggers)),
+          counts(triggers.size() + 1, 0) {}
+    virtual ~AcceptanceChannel(){};
+
+    static std::vector<std::string> slotNames(const std::vector<std::string>& triggers) {
+        std::vector<std::string> stages;
+        stages.push_back("nopt");
+        stages.push_back("nodr");
+        stages.push_back("final");
+
+        std::vector<std::string> slot_names;
+        for (auto stage : stages)
+            for (auto trig : triggers) slot_names.push_back(trig + "_" + stage);
+        return slot_names;
+    }
+
+    // the stages of an event are filled from one 64 bit mask: to be checked
+    // at startup, before building a channel
+    static bool fits(const std::vector<std::string>& triggers) {
+        return slotNames(triggers).size() <= EffCurvesTool::MAX_SLOTS;
+    }
+
+    // start a new event
+    void reset() {
+        decisions.reset();
+    }
+
+    // count an event reaching the final stage, passed(i) tells whether
+    // trigger i passed
+    template <class PASSED>
+    void count(PASSED passed) {
+        counts[0] += 1;
+        for (unsigned int itrig = 0; itrig < triggers.size(); itrig++) {
+            if (passed(itrig)) counts[itrig + 1] += 1;
+        }
+    }
+
+    // write h_acceptance and the curves in dir
+    void write(TDirectory* dir) const {
+        TDirectory* current = gDirectory;
+        dir->cd();
+
+        TH1F h("h_acceptance", "h_acceptance", triggers.size() + 1, 0, 1);
+        h.GetXaxis()->SetBinLabel(1, "notrigger");
+        for (int ib = 0; ib < h.GetNbinsX() - 1; ib++) h.GetXaxis()->SetBinLabel(ib + 2, triggers[ib].c_str());
+        for (unsigned int ib = 0; ib < counts.size(); ib++) h.AddBinContent(ib + 1, counts[ib]);
+        h.ResetStats();
+        h.Write();
+
+        for (unsigned int slot = 0; slot < curves.slots(); slot++)
+            for (auto& tool : curves.Efficiencies(slot)) (tool.second)->Write();
+        current->cd();
+    }
+
+    std::string name;
+    std::vector<std::string> triggers;
+    DecisionCache decisions;
+    EffCurvesTool curves;
+    // h_acceptance content: notrigger, then one bin per trigger
+    std::vector<unsigned long> counts;
+};
+
+// Two truth matched taus (|eta| < 2.5 outside of the crack, 1 or 3 tracks,
+// medium ID) and a jet (|eta| < 3.2) not overlapping them. The nodr stage
+// requires pt > 40, 30 and 60 GeV, the final stage 0.8 < delta R(tau, tau)
+// < 2.4 on top. A trigger passes if it fired and both taus are matched to
+// it.
+class HadHadSelection {
+  public:
+    // the tools are owned by the caller
+    HadHadSelection(Trig::TrigDecisionTool& trigDecTool, Trig::TrigTauMatchingTool& trigTauMatchingTool,
+                    TauAnalysisTools::TauTruthMatchingTool& truthMatchTool, OverlapRemovalTool& orTool)
+        : m_trigDecTool(trigDecTool),
+          m_trigTauMatchingTool(trigTauMatchingTool),
+          m_truthMatchTool(truthMatchTool),
+          m_orTool(orTool) {
+        m_jet_cuts.max_eta = 3.2;
+    }
+    virtual ~HadHadSelection(){};
+
+    // select the event and fill channel, the selections are views from
+    // arena. The truth matching tool is initialised for the event by the
+    // caller. Returns non zero if the overlap removal fails.
+    int execute(const xAOD::TauJetContainer* taus, const xAOD::JetContainer* jets, EventArena& arena,
+                AcceptanceChannel& channel);
+
+  private:
+    Trig::TrigDecisionTool& m_trigDecTool;
+    Trig::TrigTauMatchingTool& m_trigTauMatchingTool;
+    TauAnalysisTools::TauTruthMatchingTool& m_truthMatchTool;
+    OverlapRemovalTool& m_orTool;
+
+    // object selections, no pt cut on the taus and the jets
+    TauSnapshot m_tau_snapshot;
+    JetSnapshot m_jet_snapshot;
+    std::vector<char> m_mask;
+    TauCuts m_tau_cuts;
+    JetCuts m_jet_cuts;
+
+    // leading objects of the selections
+    std::vector<const xAOD::TauJet*> m_lead_taus;
+    std::vector<const xAOD::Jet*> m_lead_jets;
+};
+
+inline int HadHadSelection::execute(const xAOD::TauJetContainer* taus, const xAOD::JetContainer* jets,
+                                    EventArena& arena, AcceptanceChannel& channel) {
+    const char* APP_NAME = "HadHadSelection";
+
+    const unsigned int ntrig = channel.triggers.size();
+    const unsigned long long trig_mask = channel.decisions.all();
+
+    ConstDataVector<xAOD::TauJetContainer>* selected_taus = arena.view<xAOD::TauJetContainer>();
+
+    // |eta| < 2.5 outside of the crack, 1 or 3 tracks, medium ID
+    m_tau_snapshot.fill(*taus);
+    m_tau_snapshot.select(m_tau_cuts, m_mask);
+    pushSelected(*taus, m_mask, selected_taus);
+    for (const auto tau : *selected_taus) selectDec(*tau) = true;
+
+    if (selected_taus->size() < 2) return 0;
+
+    Utils::leading(*selected_taus, 2, Utils::comparePt, m_lead_taus);
+    const xAOD::TauJet* tau1 = m_lead_taus[0];
+    const xAOD::TauJet* tau2 = m_lead_taus[1];
+
+    auto* truth_tau1 = m_truthMatchTool.applyTruthMatch(*tau1);
+    auto* truth_tau2 = m_truthMatchTool.applyTruthMatch(*tau2);
+
+    if (truth_tau1 == NULL or truth_tau2 == NULL) return 0;
+
+    for (const auto jet : *jets) selectDec(*jet) = true;
+    // tau - jet overlap removal
+    CHECK(m_orTool.removeTauJetOverlap(*selected_taus->asDataVector(), *jets));
+
+    ConstDataVector<xAOD::JetContainer>* selected_jets = arena.view<xAOD::JetContainer>();
+
+    m_jet_snapshot.fill(*jets);
+    m_jet_snapshot.select(m_jet_cuts, m_mask);
+    for (unsigned int i = 0; i < m_mask.size(); i++) {
+        if (not m_mask[i]) continue;
+
+        const xAOD::Jet* jet = jets->at(i);
+        if (overlapAcc(*jet)) continue;
+
+        selected_jets->push_back(jet);
+    }
+
+    if (selected_jets->size() < 1) return 0;
+
+    Utils::leading(*selected_jets, 1, Utils::comparePt, m_lead_jets);
+    const xAOD::Jet* jet1 = m_lead_jets[0];
+
+    // stages reached by the event
+    unsigned long long filled = trig_mask;
+    bool final_stage = false;
+    if (not(tau1->pt() < 40000. or tau2->pt() < 30000. or jet1->pt() < 60000.)) {
+        filled |= trig_mask << ntrig;
+
+        double delta_r = tau1->p4().DeltaR(tau2->p4());
+        if (not(delta_r < 0.8 or delta_r > 2.4)) {
+            filled |= trig_mask << (2 * ntrig);
+            final_stage = true;
+        }
+    }
+
+    // trigger fired and both taus matched, evaluated on first use
+    auto eval = [&](unsigned int itrig) {
+        const std::string& trig = channel.triggers[itrig];
+        return m_trigDecTool.isPassed(trig) and m_trigTauMatchingTool.match(tau1, trig) and
+               m_trigTauMatchingTool.match(tau2, trig);
+    };
+    unsigned long long trig_passed = channel.decisions.mask(eval);
+    unsigned long long passed = filled & (trig_passed | trig_passed << ntrig | trig_passed << (2 * ntrig));
+
+    channel.curves.fill_hadhad(filled, passed, tau1, tau2, jet1);
+
+    if (not final_stage) return 0;
+
+    channel.count([&](unsigned int itrig) { return channel.decisions.passed(itrig, eval); });
+
+    // if (not trigDecTool.isPassed("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo_L1TAU20IM_2TAU12IM") and \
+    // 	trigDecTool.isPassed("HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM")) {
+    //   std::cout << " " <<  std::endl;
+    //   std::cout << "-----------------------" <<  std::endl;
+    //   std::cout << "Entry = " << entry
+    // 		<< ", RunNumber = " << ei->runNumber()
+    // 		<< " , EventNumber = " << ei->eventNumber() << std::endl;
+    //   std::cout << "Not pass HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo_L1TAU20IM_2TAU12IM but pass " \
+    // 	"HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM" << std::endl;
+    //   std::cout << "pt | eta | phi | nTracks | mediumid" << std::endl;
+    //   std::cout << "-- offline -- " << std::endl;
+    //   std::cout << tau1->pt() << " | "
+    // 		<< tau1->eta() << " | "
+    // 		<< tau1->phi() << " | "
+    // 		<< tau1->nTracks() << " | "
+    // 		<< tau1->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
+    // 		<< std::endl;
+    //   std::cout << tau2->pt() << " | "
+    // 		<< tau2->eta() << " | "
+    // 		<< tau2->phi() << " | "
+    // 		<< tau2->nTracks() << " | "
+    // 		<< tau2->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
+    // 		<< std::endl;
+    //   std::cout << "-- truth -- " << std::endl;
+    //   std::cout << truth_tau1->auxdataConst<double>("pt_vis") << " | "
+    // 		<< truth_tau1->auxdataConst<double>("eta_vis") << " | "
+    // 		<< truth_tau1->auxdataConst<double>("phi_vis") << " | "
+    // 		// << tau1->nTracks() << " | "
+    // 		// << tau1->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
+    // 		<< std::endl;
+    //   std::cout << truth_tau2->auxdataConst<double>("pt_vis") << " | "
+    // 		<< truth_tau2->auxdataConst<double>("eta_vis") << " | "
+    // 		<< truth_tau2->auxdataConst<double>("phi_vis") << " | "
+    // 		// << tau1->nTracks() << " | "
+    // 		// << tau1->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
+    // 		<< std::endl;
+    //   std::cout <<  " -- hlt features -- " << std::endl;
+    //   auto cg = trigDecTool.getChainGroup("HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM");
+    //   auto features = cg->features();
+    //   auto tauHltFeatures = features.containerFeature<xAOD::TauJetContainer>("TrigTauRecMerged");
+    //   for (auto &tauContainer: tauHltFeatures) {
+    // 	if (tauContainer.cptr()) {
+    // 	  for (auto tau: *tauContainer.cptr()) {
+    // 	    std::cout << tau->pt() << " | "
+    // 		      << tau->eta() << " | "
+    // 		      << tau->phi() << " | "
+    // 		      << tau->nTracks() << " | "
+    // 		      << tau->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
+    // 		      << std::endl;
+    // 	  }
+    // 	}
+    //   }
+    //   std::cout << "-----------------------" <<  std::endl;
+    //   std::cout << " " <<  std::endl;
+
+    // }
+
+    return 0;
+}
+
+// At least one muon passing the muon selector (|eta| < 2.5) and one
+// electron, and a truth matched tau passing the tau selector. There is no
+// delta R cut: the nodr curves stay empty, the final stage requires a tau
+// pt > 25 GeV. A trigger passes if it fired and the tau is matched to it.
+class LepHadSelection {
+  public:
+    // the tools are owned by the caller
+    LepHadSelection(Trig::TrigDecisionTool& trigDecTool, Trig::TrigTauMatchingTool& trigTauMatchingTool,
+                    TauAnalysisTools::TauTruthMatchingTool& truthMatchTool, CP::MuonSelectionTool& muonSelector,
+                    TauAnalysisTools::TauSelectionTool& tauSelector)
+        : m_trigDecTool(trigDecTool),
+          m_trigTauMatchingTool(trigTauMatchingTool),
+          m_truthMatchTool(truthMatchTool),
+          m_muonSelector(muonSelector),
+          m_tauSelector(tauSelector) {}
+    virtual ~LepHadSelection(){};
+
+    // select the event and fill channel, the selections are views from
+    // arena. The truth matching tool is initialised for the event by the
+    // caller.
+    void execute(const xAOD::TauJetContainer* taus, const xAOD::ElectronContainer* electrons,
+                 const xAOD::MuonContainer* muons, EventArena& arena, AcceptanceChannel& channel);
+
+  private:
+    Trig::TrigDecisionTool& m_trigDecTool;
+    Trig::TrigTauMatchingTool& m_trigTauMatchingTool;
+    TauAnalysisTools::TauTruthMatchingTool& m_truthMatchTool;
+    CP::MuonSelectionTool& m_muonSelector;
+    TauAnalysisTools::TauSelectionTool& m_tauSelector;
+
+    // leading tau of the selection
+    std::vector<const xAOD::TauJet*> m_lead_taus;
+};
+
+inline void LepHadSelection::execute(const xAOD::TauJetContainer* taus, const xAOD::ElectronContainer* electrons,
+                                     const xAOD::MuonContainer* muons, EventArena& arena,
+                                     AcceptanceChannel& channel) {
+    const unsigned int ntrig = channel.triggers.size();
+    const unsigned long long trig_mask = channel.decisions.all();
+
+    // ---->>>   Muons
+    ConstDataVector<xAOD::MuonContainer>* selected_muons = arena.view<xAOD::MuonContainer>();
+
+    for (const auto muon : *muons) {
+        if (not m_muonSelector.accept(muon)) continue;
+        selectDec(*muon) = true;
+        selected_muons->push_back(muon);
+    }
+    // ------------------
+
+    // ---->>> Electrons
+    ConstDataVector<xAOD::ElectronContainer>* selected_electrons = arena.view<xAOD::ElectronContainer>();
+
+    for (const auto electron : *electrons) {
+        // if (not electronSelector.accept(electron))
+        // 	continue;
+        selectDec(*electron) = true;
+        selected_electrons->push_back(electron);
+    }
+    // ------------------
+
+    if (selected_muons->size() < 1 or selected_electrons->size() < 1) return;
+
+    // ---->>>   Taus
+    ConstDataVector<xAOD::TauJetContainer>* selected_taus = arena.view<xAOD::TauJetContainer>();
+
+    for (const auto tau : *taus) {
+        if (not m_tauSelector.accept(tau)) continue;
+        selectDec(*tau) = true;
+        selected_taus->push_back(tau);
+    }
+    if (selected_taus->size() < 1) return;
+
+    Utils::leading(*selected_taus, 1, Utils::comparePt, m_lead_taus);
+    const xAOD::TauJet* tau1 = m_lead_taus[0];
+
+    auto* truth_tau1 = m_truthMatchTool.applyTruthMatch(*tau1);
+    if (truth_tau1 == NULL) return;
+    // --------------
+
+    // stages reached by the event
+    unsigned long long filled = trig_mask;
+    bool final_stage = false;
+    if (not(tau1->pt() < 25000.)) {
+        filled |= trig_mask << (2 * ntrig);
+        final_stage = true;
+    }
+
+    // trigger fired and tau matched, evaluated on first use
+    auto eval = [&](unsigned int itrig) {
+        const std::string& trig = channel.triggers[itrig];
+        return m_trigDecTool.isPassed(trig) and m_trigTauMatchingTool.match(tau1, trig);
+    };
+    unsigned long long trig_passed = channel.decisions.mask(eval);
+    unsigned long long passed = filled & (trig_passed | trig_passed << (2 * ntrig));
+
+    channel.curves.fill_lephad(filled, passed, tau1);
+
+    if (not final_stage) return;
+
+    channel.count([&](unsigned int itrig) { return channel.decisions.passed(itrig, eval); });
+
+    // // ---->>> Jets
+    // xAOD::JetContainer* selected_jets = new xAOD::JetContainer();
+    // xAOD::AuxContainerBase* selected_jets_aux = new xAOD::AuxContainerBase();
+    // selected_jets->setStore(selected_jets_aux);
+    // for (const auto jet: *jets) {
+    //   selectDec(*jet) = true;
+    //   xAOD::Jet* new_jet = new xAOD::Jet();
+    //   new_jet->makePrivateStore(*jet);
+    //   selected_jets->push_back(new_jet);
+    // }
+
+    // if (selected_jets->size() < 1)
+    //   continue;
+
+    // selected_jets->sort(Utils::comparePt);
+    // // --------------
+
+    // // tau - jet overlap removal
+    // CHECK(orTool.removeOverlaps(selected_electrons, selected_muons, selected_jets, selected_taus));
+}
+
+#endif
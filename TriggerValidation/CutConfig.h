@@ -0,0 +1,55 @@
+#ifndef TRIGGERVALIDATION_CUTCONFIG_H
+#define TRIGGERVALIDATION_CUTCONFIG_H
+
+#include <string>
+
+#include "TH1F.h"
+#include "TH2F.h"
+
+#include "TriggerValidation/FillBuffer.h"
+#include "TriggerValidation/HistogramsBook.h"
+#include "TriggerValidation/ThresholdScan.h"
+
+// One set of AcceptanceHadHadTDR event selection cuts and the histograms
+// it fills. The unnamed configuration writes the historical output names,
+// the others are put in a directory named after the configuration.
+class CutConfig {
+  public:
+    CutConfig(const std::string& name);
+    virtual ~CutConfig(){};
+
+    // parse space separated "key=value" settings, the keys are the names of
+    // the cuts below. Returns false on an unknown key or a malformed value.
+    bool configure(const std::string& settings);
+
+    // prefix of the output names
+    std::string prefix() const;
+
+    std::string name;
+
+    float tau1_pt;
+    float tau2_pt;
+
+    float min_dr_tautau;
+    float max_dr_tautau;
+
+    int n_jets;
+    float jet1_pt;
+    float jet2_pt;
+    float delta_eta_jj;
+
+    TH1F* cutflow;
+    TH1F* l1_symmetric;
+    TH1F* off_symmetric;
+    TH2F* map_l1;
+    TH2F* map_off;
+    TH2F* map_l1taus;
+    FillBuffer map_l1taus_buffer;
+
+    ThresholdScan l1_scan;
+    ThresholdScan off_scan;
+
+    HistogramsBook book;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef TRIGGERVALIDATION_DECISIONBITS_H
+#define TRIGGERVALIDATION_DECISIONBITS_H
+
+#include <string>
+#include <vector>
+
+#include "Rtypes.h"
+#include "TDirectory.h"
+#include "TTree.h"
+
+// Per-event TDT and emulation decisions of a list of chains, bit-packed.
+//
+// A "decisions" tree with one entry per event: run, lumi block, event, and
+// two fixed-width bitsets over the chain list, bit i of word i / 64 for
+// chain i. The chain names are stored once in the user info of the tree.
+// L1EmulationLoop writes it on request; decision_matrix computes the
+// confusion matrices, overlaps and unique rates from the bitsets.
+class DecisionBits {
+  public:
+    DecisionBits();
+    virtual ~DecisionBits(){};
+
+    // create the tree in dir, which owns it
+    void book(TDirectory* dir, const std::vector<std::string>& chains);
+
+    // read a tree written by book(), returns false if it misses a branch
+    bool attach(TTree* tree);
+
+    // pack the per-chain decision flags and write the event
+    void fill(unsigned int run, unsigned int lumiblock, unsigned long long event, const std::vector<char>& tdt,
+              const std::vector<char>& emulation);
+
+    const std::vector<std::string>& chains() const {
+        return m_chains;
+    }
+
+    unsigned int words() const {
+        return m_tdt.size();
+    }
+
+    static bool passed(const std::vector<ULong64_t>& bits, unsigned int chain) {
+        return (bits[chain / 64] >> (chain % 64)) & 1ULL;
+    }
+
+    // flags[i] != 0 sets bit i, bits must hold (flags.size() + 63) / 64 words
+    static void pack(const std::vector<char>& flags, std::vector<ULong64_t>& bits);
+
+    // the current event
+    UInt_t m_run;
+    UInt_t m_lumiblock;
+    ULong64_t m_event;
+    std::vector<ULong64_t> m_tdt;
+    std::vector<ULong64_t> m_emulation;
+
+  private:
+    TTree* m_tree;
+    std::vector<std::string> m_chains;
+};
+
+#endif
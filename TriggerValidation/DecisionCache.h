@@ -0,0 +1,62 @@
+#ifndef TRIGGERVALIDATION_DECISIONCACHE_H
+#define TRIGGERVALIDATION_DECISIONCACHE_H
+
+#include <cassert>
+
+// Per-event cache of the decisions of a list of triggers (at most 64).
+//
+// Two bitsets over the trigger list: the decisions already evaluated in the
+// current event and their result. A decision is evaluated on first use by
+// the functor given to passed() and reused by every later request in the
+// same event. reset() is called once at the start of every event.
+class DecisionCache {
+  public:
+    static const unsigned int MAX_TRIGGERS = 64;
+
+    // the bits are 64 bit masks: callers reject longer trigger lists at
+    // startup, before building the cache
+    DecisionCache(unsigned int ntriggers) : m_ntriggers(ntriggers), m_known(0), m_passed(0) {
+        assert(ntriggers <= MAX_TRIGGERS);
+    }
+    virtual ~DecisionCache(){};
+
+    void reset() {
+        m_known = 0;
+        m_passed = 0;
+    }
+
+    // EVAL is called as eval(index) and returns the decision of that trigger
+    template <class EVAL>
+    bool passed(unsigned int index, EVAL eval) {
+        assert(index < m_ntriggers);
+        const unsigned long long bit = 1ULL << index;
+        if (not(m_known & bit)) {
+            m_known |= bit;
+            if (eval(index)) m_passed |= bit;
+        }
+        return m_passed & bit;
+    }
+
+    // decisions of all the triggers, bit i for trigger i
+    template <class EVAL>
+    unsigned long long mask(EVAL eval) {
+        for (unsigned int i = 0; i < m_ntriggers; i++) passed(i, eval);
+        return m_passed;
+    }
+
+    // all the triggers set
+    unsigned long long all() const {
+        return m_ntriggers < MAX_TRIGGERS ? (1ULL << m_ntriggers) - 1 : ~0ULL;
+    }
+
+    unsigned int size() const {
+        return m_ntriggers;
+    }
+
+  private:
+    unsigned int m_ntriggers;
+    unsigned long long m_known;
+    unsigned long long m_passed;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef TRIGGERVALIDATION_DELTARMATCHER_H
+#define TRIGGERVALIDATION_DELTARMATCHER_H
+
+#include <vector>
+
+#include "xAODBase/IParticle.h"
+
+// Answers "is any indexed object within delta R < cone" queries.
+//
+// The objects are binned in an eta-phi grid with cells at least as wide as
+// the cone, so a query only looks at the 3x3 cells around it, with phi
+// wrapping around. Only the eta/phi of the objects are stored, as floats;
+// delta R is computed with the pseudorapidity, like TLorentzVector::DeltaR.
+// fill() replaces the indexed objects, the grid is allocated once. It does
+// not stand in for OverlapRemovalTool, which can use the rapidity and its
+// own cones: benchmark_deltar counts the jets where the two disagree.
+class DeltaRMatcher {
+  public:
+    DeltaRMatcher(double cone);
+    virtual ~DeltaRMatcher(){};
+
+    void clear();
+
+    void add(float eta, float phi);
+
+    template <class CONTAINER>
+    void fill(const CONTAINER& particles) {
+        clear();
+        for (const xAOD::IParticle* p : particles) add(p->eta(), p->phi());
+    }
+
+    // any indexed object with delta R < cone
+    bool match(float eta, float phi) const;
+
+    bool match(const xAOD::IParticle* p) const {
+        return match(p->eta(), p->phi());
+    }
+
+    unsigned int size() const {
+        return m_eta.size();
+    }
+
+  private:
+    int etaCell(float eta) const;
+    int phiCell(float phi) const;
+
+    double m_cone2;
+
+    int m_neta;
+    int m_nphi;
+    double m_eta_width;
+    double m_phi_width;
+
+    // per cell, index of the first object of the cell (-1 if empty); per
+    // object, index of the next object in the same cell
+    std::vector<int> m_head;
+    std::vector<int> m_next;
+    std::vector<int> m_used_cells;
+
+    std::vector<float> m_eta;
+    std::vector<float> m_phi;
+};
+
+#endif
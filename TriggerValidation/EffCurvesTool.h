@@ -5,32 +5,84 @@
 #include "TH1F.h"
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <EventLoop/Worker.h>
 #include "xAODBase/IParticle.h"
 #include "xAODJet/Jet.h"
 #include "xAODTau/TauJet.h"
 
+#include "TriggerValidation/EfficiencyAccumulator.h"
+
 class EffCurvesTool
 
 {
   public:
+    // curve indices, in the alphabetical order of their keys
+    enum Curve {
+        DELTA_R,
+        JET_ETA,
+        JET_PT,
+        LEADING_TAU_ETA,
+        LEADING_TAU_NTRACKS,
+        LEADING_TAU_PT,
+        SUBLEADING_TAU_ETA,
+        SUBLEADING_TAU_NTRACKS,
+        SUBLEADING_TAU_PT,
+        N_CURVES
+    };
+
+    // a slot is one full set of curves. The multi-slot fills take 64 bit
+    // masks: callers booking more than MAX_SLOTS slots must be rejected.
+    static const unsigned int MAX_SLOTS = 64;
+
     EffCurvesTool(const std::string& name);
+    // one slot per name, slot i is named names[i]
+    EffCurvesTool(const std::vector<std::string>& names);
     virtual ~EffCurvesTool(){};
 
     bool fill_hadhad(bool pass, const xAOD::TauJet* t1, const xAOD::TauJet* t2, const xAOD::Jet* j1);
 
     bool fill_lephad(bool pass, const xAOD::TauJet* t1);
 
-    std::map<std::string, TEfficiency*> Efficiencies() {
-        return m_eff;
+    // fill all the slots at once: the event is counted in slot i if bit i
+    // of filled is set, and as passed if bit i of passed is set as well.
+    // The bin of each variable is only searched once. Returns false, without
+    // filling anything, if filled has a bit set beyond the booked slots.
+    bool fill_hadhad(unsigned long long filled, unsigned long long passed, const xAOD::TauJet* t1,
+                     const xAOD::TauJet* t2, const xAOD::Jet* j1);
+
+    bool fill_lephad(unsigned long long filled, unsigned long long passed, const xAOD::TauJet* t1);
+
+    unsigned int slots() const {
+        return m_slots;
     }
 
+    // the accumulated curves of a slot as new TEfficiency objects, keyed by
+    // curve name. The tool does not keep them: each call builds a fresh set,
+    // owned by the caller and not attached to any directory. To be called
+    // once all the events are filled.
+    std::map<std::string, std::unique_ptr<TEfficiency> > Efficiencies(unsigned int slot = 0) const;
+
+    // hand the curves of all the slots over to the worker. The objects only
+    // exist once the counts are final, so unlike HistogramsBook::record this
+    // cannot be called from histInitialize: call it from finalize, after
+    // the last fill.
     void record(EL::Worker* wk);
 
   private:
-    std::map<std::string, TEfficiency*> m_eff;  //!
+    void book(const std::string& name);
+    bool booked(unsigned long long filled) const;
+    void fill(Curve curve, double x, unsigned long long filled, unsigned long long passed);
+
+    static const char* s_keys[N_CURVES];
+
+    unsigned int m_slots;
+    // slot i, curve c is m_eff[i * N_CURVES + c]
+
+    std::vector<EfficiencyAccumulator> m_eff;  //!
 };
 
 #endif
@@ -0,0 +1,63 @@
+#ifndef TRIGGERVALIDATION_EFFICIENCYACCUMULATOR_H
+#define TRIGGERVALIDATION_EFFICIENCYACCUMULATOR_H
+
+#include <string>
+#include <vector>
+
+#include "TEfficiency.h"
+
+// Passed and total counts of an efficiency curve.
+//
+// The counts are kept per bin in two contiguous arrays, with the same bin
+// numbering as TAxis (0 is the underflow, nbins + 1 the overflow). A real
+// TEfficiency is only created by efficiency(), when the result is written.
+class EfficiencyAccumulator {
+  public:
+    EfficiencyAccumulator(const std::string& name, const std::string& title, int nbins, double low, double high);
+    EfficiencyAccumulator(const std::string& name, const std::string& title, int nbins, const double* edges);
+    virtual ~EfficiencyAccumulator(){};
+
+    // same result as TAxis::FindFixBin
+    int findBin(double x) const;
+
+    void fillBin(int bin, bool pass) {
+        m_total[bin] += 1;
+        if (pass) m_passed[bin] += 1;
+    }
+
+    void fill(bool pass, double x) {
+        fillBin(findBin(x), pass);
+    }
+
+    // new TEfficiency holding the accumulated counts, owned by the caller
+    // and not attached to the current directory. The passed and total
+    // contents are set per bin, so the efficiencies match a TEfficiency
+    // filled event by event but the histogram statistics (entries, sums of
+    // weights, means) do not.
+    TEfficiency* efficiency() const;
+
+    const std::string& name() const {
+        return m_name;
+    }
+
+  private:
+    void buildLookup();
+
+    std::string m_name;
+    std::string m_title;
+
+    int m_nbins;
+    double m_low;
+    double m_high;
+
+    // variable binning: bin edges and a uniform grid giving, for each cell,
+    // the bin of the cell lower edge
+    std::vector<double> m_edges;
+    std::vector<int> m_lookup;
+    double m_cell_width;
+
+    std::vector<unsigned long> m_passed;
+    std::vector<unsigned long> m_total;
+};
+
+#endif
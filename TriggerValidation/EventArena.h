@@ -0,0 +1,85 @@
+#ifndef TRIGGERVALIDATION_EVENTARENA_H
+#define TRIGGERVALIDATION_EVENTARENA_H
+
+#include <memory>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "AthContainers/ConstDataVector.h"
+
+// Per-event pool for the temporary selection containers.
+//
+// view<C>() hands out an empty ConstDataVector<C> (SG::VIEW_ELEMENTS) owned
+// by the arena. reset() is called once at the start of every event: all the
+// views are cleared and handed out again, keeping their capacity, so after
+// the first few events nothing is allocated anymore and nothing can leak on
+// an early return.
+class EventArena {
+  public:
+    EventArena() {}
+    virtual ~EventArena(){};
+
+    void reset() {
+        for (auto& p : m_pools) p.second->reset();
+    }
+
+    template <class CONTAINER>
+    ConstDataVector<CONTAINER>* view() {
+        return pool<CONTAINER>()->acquire();
+    }
+
+    // number of views allocated since the arena was created
+    unsigned int allocated() const {
+        unsigned int n = 0;
+        for (const auto& p : m_pools) n += p.second->allocated();
+        return n;
+    }
+
+  private:
+    class PoolBase {
+      public:
+        virtual ~PoolBase(){};
+        virtual void reset() = 0;
+        virtual unsigned int allocated() const = 0;
+    };
+
+    template <class CONTAINER>
+    class Pool : public PoolBase {
+      public:
+        Pool() : m_used(0) {}
+
+        ConstDataVector<CONTAINER>* acquire() {
+            if (m_used == m_views.size()) m_views.emplace_back(new ConstDataVector<CONTAINER>(SG::VIEW_ELEMENTS));
+            return m_views[m_used++].get();
+        }
+
+        virtual void reset() {
+            for (unsigned int i = 0; i < m_used; i++) m_views[i]->clear();
+            m_used = 0;
+        }
+
+        virtual unsigned int allocated() const {
+            return m_views.size();
+        }
+
+      private:
+        std::vector<std::unique_ptr<ConstDataVector<CONTAINER> > > m_views;
+        unsigned int m_used;
+    };
+
+    // a handful of container types per job: a linear search is enough
+    template <class CONTAINER>
+    Pool<CONTAINER>* pool() {
+        for (auto& p : m_pools) {
+            if (*p.first == typeid(CONTAINER)) return static_cast<Pool<CONTAINER>*>(p.second.get());
+        }
+        Pool<CONTAINER>* new_pool = new Pool<CONTAINER>();
+        m_pools.push_back(std::make_pair(&typeid(CONTAINER), std::unique_ptr<PoolBase>(new_pool)));
+        return new_pool;
+    }
+
+    std::vector<std::pair<const std::type_info*, std::unique_ptr<PoolBase> > > m_pools;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TRIGGERVALIDATION_FILLBUFFER_H
+#define TRIGGERVALIDATION_FILLBUFFER_H
+
+#include <vector>
+
+#include "TH1.h"
+
+// Buffered filling of a histogram.
+//
+// The (x, [y,] weight) entries are stored in contiguous arrays and handed
+// to TH1::FillN (TH2::FillN for 2D histograms) once size entries have been
+// collected. flush() has to be called before the histogram is written out.
+class FillBuffer {
+  public:
+    FillBuffer(TH1* hist = NULL, unsigned int size = 1000);
+    virtual ~FillBuffer(){};
+
+    void setHist(TH1* hist);
+    void setSize(unsigned int size);
+
+    TH1* hist() const {
+        return m_hist;
+    }
+
+    void fill(double x, double weight = 1.0) {
+        m_x.push_back(x);
+        m_weights.push_back(weight);
+        if (m_x.size() >= m_size) flush();
+    }
+
+    void fill(double x, double y, double weight) {
+        m_y.push_back(y);
+        fill(x, weight);
+    }
+
+    void flush();
+
+  private:
+    TH1* m_hist;
+    unsigned int m_size;
+
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_weights;
+};
+
+#endif
@@ -9,6 +9,9 @@
 #include "TrigTauEmulation/HltEmulationTool.h"
 #include "TrigTauEmulation/Level1EmulationTool.h"
 #include "TrigTauEmulation/ToolsRegistry.h"
+#include "TriggerValidation/MismatchRecorder.h"
+#include "TriggerValidation/ReplayList.h"
+#include "TriggerValidation/RoIFeatureIndex.h"
 
 #include "xAODTau/TauJet.h"
 
@@ -23,6 +26,13 @@ class HLTEmulationLoop : public EL::Algorithm
     std::vector<std::string> chains_to_test;
     std::string reference_chain;
     unsigned int trigger_condition;
+    // print the disagreements and the decorated HLT taus on stdout, on top
+    // of recording them
+    bool print_mismatches;
+    // replay mode: only the listed (file, entry) pairs are processed, all
+    // the entries when empty
+    std::vector<std::string> replay_files;
+    std::vector<Long64_t> replay_entries;
 
     // variables that don't get filled at submission time should be
     // protected from being send from the submission node to the worker
@@ -31,6 +41,9 @@ class HLTEmulationLoop : public EL::Algorithm
     TH1F* h_TDT_EMU_diff;  //!
     TH1F* h_TDT_fires;     //!
     TH1F* h_EMU_fires;     //!
+    // events read, events stopped by the reference chain or the preselection
+    // taus, and the EDM retrievals saved by stopping them
+    TH1F* h_event_gates;  //!
     // Tree *myTree; //!
     // TH1 *myHist; //!
     Trig::TrigDecisionTool* m_trigDecisionTool;  //!
@@ -42,6 +55,29 @@ class HLTEmulationLoop : public EL::Algorithm
     ToolsRegistry* m_registry;       //!
     ChainRegistry* m_chainRegistry;  //!
 
+    // resolved once in initialize(), indexed in the order of
+    // m_hlt_emulationTool->getHltChains(): the emulated chain names, the
+    // trimmed names used by the TDT and as histogram labels, and the chain
+    // group handles
+    std::vector<std::string> m_hlt_chains;               //!
+    std::vector<std::string> m_chain_labels;             //!
+    std::vector<const Trig::ChainGroup*> m_chain_groups;  //!
+    const Trig::ChainGroup* m_reference_group;           //!
+
+    // per-event association of the tracks and calo-only taus to the HLT taus
+    RoIFeatureIndex m_roi_index;  //!
+
+    MismatchRecorder m_mismatches;  //!
+    ReplayList m_replay;            //!
+
+    // events reaching the emulation, and the HLT objects deep-copied for
+    // them by the current extraction. m_n_copied_former is an estimate, not
+    // a measurement: the sizes of the containers the former extraction
+    // copied (every preselection tau and track, each HLT tau twice)
+    unsigned long long m_n_events;          //!
+    unsigned long long m_n_copied;          //!
+    unsigned long long m_n_copied_former;   //!
+
     // this is a standard constructor
     HLTEmulationLoop();
 
@@ -57,7 +93,7 @@ class HLTEmulationLoop : public EL::Algorithm
     virtual EL::StatusCode histFinalize();
 
     // this is needed to distribute the algorithm to the workers
-    ClassDef(HLTEmulationLoop, 1);
+    ClassDef(HLTEmulationLoop, 3);
 };
 
 #endif
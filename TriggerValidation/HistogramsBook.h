@@ -1,20 +1,52 @@
 #ifndef TRIGGERVALIDATION_HISTOGRAMSBOOK_H
 #define TRIGGERVALIDATION_HISTOGRAMSBOOK_H
 
-#include <map>
+#include <string>
 
 #include "TH1F.h"
 
+#include "AthContainers/AuxElement.h"
 #include "xAODJet/Jet.h"
 #include "xAODTau/TauJet.h"
 #include "xAODTruth/TruthParticle.h"
 
 #include "EventLoop/Worker.h"
 
+#include "TriggerValidation/FillBuffer.h"
+
 class HistogramsBook
 
 {
   public:
+    // histogram indices, in the alphabetical order of their names which is
+    // also the order in which they are recorded
+    enum Index {
+        JET1_ETA,
+        JET1_PHI,
+        JET1_PT,
+        JET2_ETA,
+        JET2_PHI,
+        JET2_PT,
+        TAU1_BDT,
+        TAU1_ETA,
+        TAU1_NTRACKS,
+        TAU1_PHI,
+        TAU1_PT,
+        TAU2_BDT,
+        TAU2_ETA,
+        TAU2_NTRACKS,
+        TAU2_PHI,
+        TAU2_PT,
+        TAUTAU_DR,
+        TRUTH_TAU1_ETA,
+        TRUTH_TAU1_PHI,
+        TRUTH_TAU1_PT,
+        TRUTH_TAU2_ETA,
+        TRUTH_TAU2_PHI,
+        TRUTH_TAU2_PT,
+        N_HISTS
+    };
+
     HistogramsBook(const std::string& name);
     virtual ~HistogramsBook(){};
 
@@ -26,9 +58,31 @@ class HistogramsBook
 
     void record(EL::Worker* wk);
 
+    // the fills are buffered, flush() before the histograms are written
+    void setBufferSize(unsigned int size);
+    void flush();
+
+    TH1F* get(Index index) const {
+        return m_h1d[index];
+    }
+
   private:
+    struct Schema {
+        const char* name;
+        const char* title;
+        int nbins;
+        double low;
+        double high;
+    };
+    static const Schema s_schema[N_HISTS];
+
+    static const SG::AuxElement::ConstAccessor<double> s_pt_vis;
+    static const SG::AuxElement::ConstAccessor<double> s_eta_vis;
+    static const SG::AuxElement::ConstAccessor<double> s_phi_vis;
+
     std::string m_name;
-    std::map<std::string, TH1F*> m_h1d;
+    TH1F* m_h1d[N_HISTS];
+    FillBuffer m_buffers[N_HISTS];  //!
 };
 
 #endif
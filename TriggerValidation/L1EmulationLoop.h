@@ -7,8 +7,15 @@
 #include "TrigTauEmulation/ChainRegistry.h"
 #include "TrigTauEmulation/Level1EmulationTool.h"
 #include "TrigTauEmulation/ToolsRegistry.h"
+#include "TriggerValidation/DecisionBits.h"
+#include "TriggerValidation/MismatchRecorder.h"
+#include "TriggerValidation/RateAccumulator.h"
+#include "TriggerValidation/ThresholdSweep.h"
+#include "TriggerValidation/ReplayList.h"
 
+#include "TH1D.h"
 #include "TH1F.h"
+#include "TH2D.h"
 
 class L1EmulationLoop : public EL::Algorithm {
     // put your configuration variables here as public variables.
@@ -16,6 +23,27 @@ class L1EmulationLoop : public EL::Algorithm {
   public:
     // float cutValue;
     std::vector<std::string> l1_chains;
+    // print the disagreements and the topo combinations on stdout, on top
+    // of recording them
+    bool print_mismatches;
+    // replay mode: only the listed (file, entry) pairs are processed, all
+    // the entries when empty
+    std::vector<std::string> replay_files;
+    std::vector<Long64_t> replay_entries;
+    // write the bit-packed TDT and emulation decisions of every event to
+    // the l1_decisions output stream
+    bool write_decisions;
+    // rate mode: EnhancedBias weights file ("run event weight" lines), the
+    // emulated rates of the items are computed when set, and the live time
+    // of the sample in seconds (weighted counts if 0)
+    std::string eb_weights;
+    double eb_livetime;
+    // threshold sweep mode: pass maps of the TAU (and TAU IM), EM and J
+    // items over these thresholds in GeV, in increasing order; a family is
+    // swept when its list is not empty
+    std::vector<int> sweep_tau_thresholds;
+    std::vector<int> sweep_em_thresholds;
+    std::vector<int> sweep_jet_thresholds;
 
     Trig::TrigDecisionTool* m_trigDecisionTool;  //!
     TrigConf::xAODConfigTool* m_trigConfigTool;  //!
@@ -29,6 +57,33 @@ class L1EmulationLoop : public EL::Algorithm {
     unsigned int m_nMuonTools; //!
     unsigned int m_nEnergySumTools; //!
 
+    // indexed in the order of l1_chains: whether the item is known to the
+    // TDT, updated on the first event and when the configuration keys
+    // change, and its chain group handle, created in initialize()
+    std::vector<char> m_chain_exists;                     //!
+    std::vector<const Trig::ChainGroup*> m_chain_groups;  //!
+    bool m_config_known;                                  //!
+    unsigned int m_smk;                                   //!
+    unsigned int m_l1psk;                                 //!
+
+    // per-event decisions, one flag per item: TDT passed before prescale,
+    // TDT passed before prescale or after veto, and emulation passed
+    std::vector<char> m_tdt_passed;  //!
+    std::vector<char> m_tdt_fired;   //!
+    std::vector<char> m_emu_passed;  //!
+
+    MismatchRecorder m_mismatches;  //!
+    ReplayList m_replay;            //!
+    DecisionBits m_decisions;       //!
+
+    // rate mode
+    EnhancedBiasWeights m_eb_weights;    //!
+    RateAccumulator* m_rates;            //!
+    std::vector<ULong64_t> m_emu_bits;   //!
+    unsigned long m_n_unweighted;        //!
+
+    ThresholdSweep m_sweep;  //!
+
     // variables that don't get filled at submission time should be
     // protected from being send from the submission node to the worker
     // node (done by the //!)
@@ -37,6 +92,13 @@ class L1EmulationLoop : public EL::Algorithm {
     TH1F* h_TDT_fires;     //!
     TH1F* h_EMU_fires;     //!
 
+    // rate mode: emulated rate of each item, of each item alone, of each
+    // pair of items, and of any item
+    TH1D* h_rate;          //!
+    TH1D* h_unique_rate;   //!
+    TH2D* h_overlap_rate;  //!
+    TH1D* h_union_rate;    //!
+
     // Tree *myTree; //!
     // TH1 *myHist; //!
 
@@ -54,8 +116,11 @@ class L1EmulationLoop : public EL::Algorithm {
     virtual EL::StatusCode finalize();
     virtual EL::StatusCode histFinalize();
 
+    // recompute m_chain_exists for the current configuration
+    void updateChains();
+
     // this is needed to distribute the algorithm to the workers
-    ClassDef(L1EmulationLoop, 1);
+    ClassDef(L1EmulationLoop, 6);
 };
 
 #endif
@@ -0,0 +1,104 @@
+#ifndef TRIGGERVALIDATION_MISMATCHRECORDER_H
+#define TRIGGERVALIDATION_MISMATCHRECORDER_H
+
+#include <string>
+#include <vector>
+
+#include "Rtypes.h"
+#include "TDirectory.h"
+#include "TTree.h"
+
+#include "xAODTrigger/EmTauRoIContainer.h"
+
+// Records the events where the TDT and the emulation disagree.
+//
+// One entry per disagreeing event in a "mismatches" tree: the input file
+// and entry, run, event and lumi block, the index in the chain list and the TDT and emulation
+// decisions of every disagreeing chain, and the kinematics of the RoIs and
+// HLT features the emulation ran on. The chain names are stored once in
+// the user info of the tree. The emulation loops write the tree to an
+// output stream of the worker; read_mismatches prints and filters it, and
+// validator --replay runs the emulation again on the recorded entries.
+class MismatchRecorder {
+  public:
+    // new kinds go at the end, the values are stored in the trees
+    enum Kind { L1_TAU, L1_JET, L1_MUON, L1_XE, HLT_TAU, HLT_CALO_ONLY_TAU, L1_EM, N_KINDS };
+
+    MismatchRecorder();
+    virtual ~MismatchRecorder(){};
+
+    // create the tree in dir, which owns it
+    void book(TDirectory* dir, const std::vector<std::string>& chains);
+
+    // read the records of a tree written by book(), returns false if the
+    // tree misses a branch
+    bool attach(TTree* tree);
+
+    // name of the input file of the next events
+    void setInput(const std::string& file) {
+        m_file = file;
+    }
+
+    // start a new event, forgetting the chains and objects of the last one
+    void clear(Long64_t entry, unsigned int run, unsigned long long event, unsigned int lumiblock);
+
+    void addChain(unsigned int index, bool tdt, bool emulation);
+
+    void addObject(Kind kind, float pt, float eta, float phi);
+
+    template <class CONTAINER, class ET>
+    void addObjects(Kind kind, const CONTAINER& objects, ET et) {
+        for (auto object : objects) addObject(kind, et(object), object->eta(), object->phi());
+    }
+
+    // the LVL1EmTauRoIs hold both RoI types: the tau RoIs are recorded as
+    // L1_TAU with tauClus() and the EM RoIs as L1_EM with emClus(), the
+    // cluster ETs the items cut on
+    void addEmTauRoIs(const xAOD::EmTauRoIContainer& rois);
+
+    // number of disagreeing chains in the current event
+    unsigned int size() const {
+        return m_chain.size();
+    }
+
+    // write the current event if any chain disagrees
+    void write();
+
+    const std::vector<std::string>& chains() const {
+        return m_chains;
+    }
+
+    static const char* kindName(Kind kind);
+
+    // the current record
+    std::string m_file;
+    Long64_t m_entry;
+    unsigned int m_run;
+    unsigned long long m_event;
+    unsigned int m_lumiblock;
+
+    std::vector<int> m_chain;
+    std::vector<char> m_tdt;
+    std::vector<char> m_emulation;
+
+    std::vector<int> m_kind;
+    std::vector<float> m_pt;
+    std::vector<float> m_eta;
+    std::vector<float> m_phi;
+
+  private:
+    TTree* m_tree;
+    std::vector<std::string> m_chains;
+
+    // branch addresses of the file name and the vectors when reading
+    std::string* m_file_ptr;
+    std::vector<int>* m_chain_ptr;
+    std::vector<char>* m_tdt_ptr;
+    std::vector<char>* m_emulation_ptr;
+    std::vector<int>* m_kind_ptr;
+    std::vector<float>* m_pt_ptr;
+    std::vector<float>* m_eta_ptr;
+    std::vector<float>* m_phi_ptr;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TRIGGERVALIDATION_RATEACCUMULATOR_H
+#define TRIGGERVALIDATION_RATEACCUMULATOR_H
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Rtypes.h"
+#include "TH1D.h"
+#include "TH2D.h"
+
+// Per-event EnhancedBias weights, read from a text file with one
+// "run event weight" line per event ('#' starts a comment).
+class EnhancedBiasWeights {
+  public:
+    EnhancedBiasWeights() {}
+    virtual ~EnhancedBiasWeights(){};
+
+    // returns false if the file cannot be read or has a malformed line
+    bool read(const std::string& path);
+
+    // weight of an event, false if the event is not in the file
+    bool weight(unsigned int run, unsigned long long event, double& w) const;
+
+    unsigned int size() const {
+        return m_weights.size();
+    }
+
+  private:
+    struct Key {
+        unsigned int run;
+        unsigned long long event;
+        bool operator==(const Key& other) const {
+            return run == other.run and event == other.event;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<unsigned long long>()(key.event * 1000003ULL + key.run);
+        }
+    };
+
+    std::unordered_map<Key, double, KeyHash> m_weights;
+};
+
+// Weighted pass, union, overlap and unique counts of a list of items.
+//
+// fill() takes the decisions of an event packed in 64-bit words (see
+// DecisionBits::pack) and its weight: the union is a test on the words,
+// the unique events have a popcount of one, and only the set bits are
+// visited for the per-item and pairwise sums. Dividing the sums by the
+// live time of the sample gives the rates. The sums of the squared
+// weights are kept for the errors.
+class RateAccumulator {
+  public:
+    RateAccumulator(unsigned int nitems);
+    virtual ~RateAccumulator(){};
+
+    void fill(const std::vector<ULong64_t>& bits, double w);
+
+    // write the sums, scaled by 1 / livetime when livetime > 0, into
+    // histograms with one bin per item (n x n for the overlaps) and a
+    // single bin for the union
+    void write(TH1D* h_pass, TH1D* h_unique, TH2D* h_overlap, TH1D* h_union, double livetime) const;
+
+    double events() const {
+        return m_events;
+    }
+
+  private:
+    unsigned int m_nitems;
+
+    double m_events;
+    double m_union;
+    double m_union2;
+    std::vector<double> m_pass;
+    std::vector<double> m_pass2;
+    std::vector<double> m_unique;
+    std::vector<double> m_unique2;
+    std::vector<double> m_overlap;
+    std::vector<double> m_overlap2;
+
+    std::vector<unsigned int> m_fired;
+};
+
+#endif
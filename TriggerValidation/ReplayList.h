@@ -0,0 +1,49 @@
+#ifndef TRIGGERVALIDATION_REPLAYLIST_H
+#define TRIGGERVALIDATION_REPLAYLIST_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Rtypes.h"
+
+// Entries of the current input file to replay.
+//
+// The replay list is given as parallel (file, entry) vectors, as recorded
+// in the mismatches trees. select() is called on every input file change
+// and keeps the sorted entries of that file; contains() is then a binary
+// search. An empty list replays everything.
+class ReplayList {
+  public:
+    ReplayList() : m_active(false) {}
+    virtual ~ReplayList(){};
+
+    void select(const std::vector<std::string>& files, const std::vector<Long64_t>& entries, const std::string& file) {
+        m_active = not entries.empty();
+        m_entries.clear();
+        for (unsigned int i = 0; i < entries.size() and i < files.size(); i++) {
+            if (files[i] == file) m_entries.push_back(entries[i]);
+        }
+        std::sort(m_entries.begin(), m_entries.end());
+        m_entries.erase(std::unique(m_entries.begin(), m_entries.end()), m_entries.end());
+    }
+
+    bool active() const {
+        return m_active;
+    }
+
+    // whether an entry of the current file is replayed
+    bool contains(Long64_t entry) const {
+        return not m_active or std::binary_search(m_entries.begin(), m_entries.end(), entry);
+    }
+
+    unsigned int size() const {
+        return m_entries.size();
+    }
+
+  private:
+    bool m_active;
+    std::vector<Long64_t> m_entries;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef TRIGGERVALIDATION_ROIFEATUREINDEX_H
+#define TRIGGERVALIDATION_ROIFEATUREINDEX_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "TrigNavStructure/TrigNavStructure.h"
+#include "TrigNavStructure/TriggerElement.h"
+
+// Associates HLT features through the navigation RoIs they come from.
+//
+// The features are added once per event with the trigger element they are
+// attached to; each is filed under the RoI nodes of that element. find()
+// then returns the features of a kind sharing an RoI with another trigger
+// element -- the features for which HLT::TrigNavStructure::haveCommonRoI
+// is true -- with one lookup per RoI instead of one navigation query per
+// feature. The lists are kept between events, clear() only empties them.
+class RoIFeatureIndex {
+  public:
+    enum Kind { ISO_TRACKS, CORE_TRACKS, CALO_ONLY_TAUS, N_KINDS };
+
+    RoIFeatureIndex() : m_nrois(0) {}
+    virtual ~RoIFeatureIndex(){};
+
+    void clear();
+
+    void add(Kind kind, unsigned int feature, const HLT::TriggerElement* te);
+
+    // FEATURES is a vector of Trig::Feature / Trig::AsgFeature, indexed by
+    // position in the vector
+    template <class FEATURES>
+    void add(Kind kind, const FEATURES& features) {
+        for (unsigned int i = 0; i < features.size(); i++) add(kind, i, features[i].te());
+    }
+
+    // look up the features of every kind sharing an RoI with te, walking
+    // the RoI nodes of te once; the result is read with found()
+    void find(const HLT::TriggerElement* te);
+
+    // indices of the features of a kind found by the last find(), in
+    // increasing order and each once
+    const std::vector<unsigned int>& found(Kind kind) const {
+        return m_found[kind];
+    }
+
+    unsigned int rois() const {
+        return m_nrois;
+    }
+
+  private:
+    // the RoI nodes of a trigger element, the element itself for an RoI node
+    void roiNodes(const HLT::TriggerElement* te);
+
+    std::unordered_map<const HLT::TriggerElement*, unsigned int> m_roi_slots;
+    unsigned int m_nrois;
+
+    // features of RoI slot r and kind k in m_features[r * N_KINDS + k]
+    std::vector<std::vector<unsigned int> > m_features;
+
+    std::vector<const HLT::TriggerElement*> m_nodes;
+    std::vector<unsigned int> m_found[N_KINDS];
+};
+
+#endif
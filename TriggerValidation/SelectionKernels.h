@@ -0,0 +1,87 @@
+#ifndef TRIGGERVALIDATION_SELECTIONKERNELS_H
+#define TRIGGERVALIDATION_SELECTIONKERNELS_H
+
+#include <vector>
+
+#include "AthContainers/ConstDataVector.h"
+#include "xAODJet/JetContainer.h"
+#include "xAODTau/TauJetContainer.h"
+
+// Object selections evaluated on structure-of-arrays snapshots.
+//
+// fill() reads the kinematics (and the tau tracks and ID) of a container
+// once per event into contiguous arrays; select() evaluates all the cuts of
+// an object as one branch-free expression, writing mask[i] = 1 for the
+// objects passing. The xAOD four-momenta are stored as floats, the
+// snapshots keep them exactly and the cuts are compared in double, so the
+// result is the same as cutting on the objects.
+
+// an object is rejected if pt < min_pt, |eta| > max_eta, crack_low < |eta| <
+// crack_high, it has neither 1 nor 3 tracks, or fails the medium BDT ID
+struct TauCuts {
+    TauCuts() : min_pt(0.), max_eta(2.5), crack_low(1.37), crack_high(1.52), medium_id(true) {}
+
+    double min_pt;
+    double max_eta;
+    double crack_low;
+    double crack_high;
+    bool medium_id;
+};
+
+// an object is rejected if pt < min_pt or |eta| > max_eta
+struct JetCuts {
+    JetCuts() : min_pt(0.), max_eta(4.9) {}
+
+    double min_pt;
+    double max_eta;
+};
+
+class TauSnapshot {
+  public:
+    TauSnapshot() {}
+    virtual ~TauSnapshot(){};
+
+    void fill(const xAOD::TauJetContainer& taus);
+
+    // returns the number of passing taus
+    unsigned int select(const TauCuts& cuts, std::vector<char>& mask) const;
+
+    unsigned int size() const {
+        return m_pt.size();
+    }
+
+  private:
+    std::vector<float> m_pt;
+    std::vector<float> m_eta;
+    std::vector<int> m_ntracks;
+    std::vector<char> m_medium;
+};
+
+class JetSnapshot {
+  public:
+    JetSnapshot() {}
+    virtual ~JetSnapshot(){};
+
+    void fill(const xAOD::JetContainer& jets);
+
+    // returns the number of passing jets
+    unsigned int select(const JetCuts& cuts, std::vector<char>& mask) const;
+
+    unsigned int size() const {
+        return m_pt.size();
+    }
+
+  private:
+    std::vector<float> m_pt;
+    std::vector<float> m_eta;
+};
+
+// push the objects with a non-zero mask into a view, in container order
+template <class CONTAINER>
+void pushSelected(const CONTAINER& objects, const std::vector<char>& mask, ConstDataVector<CONTAINER>* selected) {
+    for (unsigned int i = 0; i < mask.size(); i++) {
+        if (mask[i]) selected->push_back(objects[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef TRIGGERVALIDATION_THRESHOLDSCAN_H
+#define TRIGGERVALIDATION_THRESHOLDSCAN_H
+
+#include <string>
+#include <vector>
+
+#include "TAxis.h"
+#include "TH1F.h"
+#include "TH2F.h"
+
+// Threshold scan of a (leading, subleading) pair of objects.
+//
+// A value passes the threshold i if value >= threshold[i]. The thresholds
+// are non-decreasing, so the passed thresholds always form a prefix and an
+// event reduces to the length of that prefix. Only one counter per event is
+// incremented in fill(); the cumulative symmetric histogram and asymmetric
+// map are built in finalize().
+class ThresholdScan {
+  public:
+    ThresholdScan();
+    virtual ~ThresholdScan(){};
+
+    // symmetric: bin i is filled if both objects pass sublead_thresholds[i]
+    // map: bin (j, i), j >= i, is filled if the leading object passes
+    // lead_thresholds[j] and the subleading one passes sublead_thresholds[i]
+    void setup(const std::vector<double>& lead_thresholds, const std::vector<double>& sublead_thresholds, TH1F* h_symmetric,
+               const std::vector<std::string>& symmetric_labels, TH2F* h_map, const std::vector<std::string>& lead_labels,
+               const std::vector<std::string>& sublead_labels);
+
+    void fill(double lead, double sublead);
+
+    // write the accumulated counts into the histograms
+    void finalize();
+
+  private:
+    static unsigned int passed(const std::vector<double>& thresholds, double value);
+    static int findLabel(const TAxis* axis, const std::string& label);
+    static void addLabel(TAxis* axis, const std::string& label);
+
+    std::vector<double> m_lead;
+    std::vector<double> m_sublead;
+
+    TH1F* m_symmetric;
+    TH2F* m_map;
+
+    std::vector<std::string> m_symmetric_labels;
+    std::vector<std::string> m_lead_labels;
+    std::vector<std::string> m_sublead_labels;
+
+    // number of events per length of the passed prefix
+    std::vector<unsigned long> m_symmetric_counts;
+    std::vector<unsigned long> m_map_counts;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef TRIGGERVALIDATION_THRESHOLDSWEEP_H
+#define TRIGGERVALIDATION_THRESHOLDSWEEP_H
+
+#include <string>
+#include <vector>
+
+#include "TH1F.h"
+#include "TH2F.h"
+
+#include "xAODTrigger/EmTauRoIContainer.h"
+#include "xAODTrigger/JetRoIContainer.h"
+
+#include "TriggerValidation/ThresholdScan.h"
+
+// Pass maps of families of L1 items over a grid of thresholds.
+//
+// The tau, EM and jet RoIs of an event are sorted by ET once per family;
+// an item of the family reduces to the leading and subleading ET among the
+// RoIs passing its mask (all of them, or the isolated ones for the IM
+// variant), and ThresholdScan turns those into prefix counts over the
+// threshold grid. Per family, three histograms are filled, with bins
+// labelled by item name:
+// - h_sweep_<family>_single: X<t> passes, the leading RoI has ET >= t
+// - h_sweep_<family>_pair: 2X<t> passes, two RoIs have ET >= t
+// - h_sweep_<family>_map: X<t1>_2X<t2>, t1 >= t2, passes
+// The ET cuts are ET >= threshold, like the l1 scan of AcceptanceHadHadTDR.
+class ThresholdSweep {
+  public:
+    // TAU_IM: tau RoIs with emIsol <= 2 GeV + 10% of the cluster ET, the
+    // isolation is not applied above 60 GeV
+    enum Family { TAU, TAU_IM, EM, JET, N_FAMILIES };
+
+    ThresholdSweep();
+    virtual ~ThresholdSweep(){};
+
+    // thresholds in GeV, in increasing order; the new histograms are
+    // appended to hists, for the caller to register
+    void book(Family family, const std::vector<int>& thresholds, std::vector<TH1*>& hists);
+
+    bool active() const;
+
+    // whether the booked families read the LVL1EmTauRoIs (TAU, TAU_IM, EM)
+    // and the LVL1JetRoIs (JET)
+    bool needsEmTaus() const;
+    bool needsJets() const;
+
+    // the containers of the families not booked can be null
+    void fill(const xAOD::EmTauRoIContainer* emtaus, const xAOD::JetRoIContainer* jets);
+
+    // write the accumulated counts into the histograms
+    void finalize();
+
+    static std::string name(Family family);
+    static bool isolated(const xAOD::EmTauRoI* roi);
+
+  private:
+    void fillFamily(Family family, const std::vector<float>& et, const std::vector<char>* mask);
+
+    bool m_active[N_FAMILIES];
+    ThresholdScan m_single[N_FAMILIES];
+    ThresholdScan m_pair[N_FAMILIES];
+
+    // per-event RoIs sorted by decreasing ET, with the tau isolation mask
+    std::vector<std::pair<float, char> > m_sorted;
+    std::vector<float> m_et;
+    std::vector<char> m_isolated;
+};
+
+#endif
@@ -12,6 +12,14 @@
 
 #include "AssociationUtils/OverlapRemovalTool.h"
 
+#include <TError.h>
+#include <TFileMerger.h>
+#include <TSystem.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
 #include <string>
 #include <vector>
 
@@ -49,6 +57,27 @@ namespace Utils {
         return (t1->tauClus() > t2->tauClus() ? true : false);
     }
 
+    // the k leading objects according to comp (e.g. comparePt or
+    // compareTauClus), in one pass over the container and without copying
+    // it. Equal objects keep their container order, which is what sort()
+    // gives for containers of up to 16 objects (insertion sort).
+    template <class CONTAINER, class OBJECT, class COMPARE>
+    void leading(const CONTAINER& objects, unsigned int k, COMPARE comp, std::vector<const OBJECT*>& top) {
+        top.clear();
+        if (k == 0) return;
+
+        for (const OBJECT* obj : objects) {
+            // insert after the objects ranked before or equal to it
+            unsigned int pos = top.size();
+            while (pos > 0 and comp(obj, top[pos - 1])) pos--;
+            if (pos >= k) continue;
+
+            if (top.size() < k) top.push_back(obj);
+            for (unsigned int i = top.size() - 1; i > pos; i--) top[i] = top[i - 1];
+            top[pos] = obj;
+        }
+    }
+
     std::vector<std::string> splitNames(const std::string& files, std::string sep = ",") {
         std::vector<std::string> fileList;
         for (size_t i = 0, n; i <= files.length(); i = n + 1) {
@@ -68,6 +97,73 @@ namespace Utils {
         }
         return fileList;
     }
+
+    // boundaries of nparts contiguous ranges covering [0, entries): range i
+    // is [bounds[i], bounds[i + 1]), the sizes differ by at most one
+    std::vector<long long> splitEntries(long long entries, unsigned int nparts) {
+        std::vector<long long> bounds;
+        for (unsigned int i = 0; i <= nparts; i++) bounds.push_back(entries * i / nparts);
+        return bounds;
+    }
+
+    // run work(part, first, last, fname) over nparts contiguous ranges of
+    // [0, entries), each in its own forked process writing its result to
+    // fname = output.<part>, then merge the partial files into output (as
+    // hadd does) and remove them. The xAOD active event/store, the ToolStore
+    // and the trigger tools are process-wide, hence processes and not
+    // threads. A single part runs in this process and writes output
+    // directly. Returns 0 if all the parts succeeded.
+    template <class WORK>
+    int forkRanges(long long entries, unsigned int nparts, const std::string& output, WORK work) {
+        if (nparts <= 1) return work(0, 0LL, entries, output);
+
+        std::vector<long long> bounds = splitEntries(entries, nparts);
+        std::vector<std::string> parts;
+        std::vector<pid_t> pids;
+
+        // nothing buffered may be written twice
+        std::fflush(NULL);
+        for (unsigned int i = 0; i < nparts; i++) {
+            parts.push_back(output + "." + std::to_string(i));
+            pid_t pid = fork();
+            if (pid < 0) {
+                ::Error("forkRanges", "Failed to fork part %u", i);
+                nparts = i;
+                break;
+            }
+            if (pid == 0) {
+                int status = work(i, bounds[i], bounds[i + 1], parts[i]);
+                std::fflush(NULL);
+                // skip the exit handlers of the parent's ROOT state
+                _exit(status == 0 ? 0 : 1);
+            }
+            pids.push_back(pid);
+        }
+
+        int failed = pids.size() < parts.size() ? 1 : 0;
+        for (unsigned int i = 0; i < pids.size(); i++) {
+            int status = 0;
+            if (waitpid(pids[i], &status, 0) < 0 or not WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+                ::Error("forkRanges", "Part %u, entries [%lld, %lld), failed", i, bounds[i], bounds[i + 1]);
+                failed = 1;
+            }
+        }
+
+        if (failed == 0) {
+            TFileMerger merger(false);
+            if (not merger.OutputFile(output.c_str(), "RECREATE")) failed = 1;
+            for (unsigned int i = 0; i < parts.size() and failed == 0; i++) {
+                if (not merger.AddFile(parts[i].c_str())) failed = 1;
+            }
+            if (failed == 0 and not merger.Merge()) failed = 1;
+            if (failed != 0) ::Error("forkRanges", "Failed to merge the partial outputs into %s", output.c_str());
+        }
+
+        // keep the partial files if the merge failed
+        if (failed == 0)
+            for (auto part : parts) gSystem->Unlink(part.c_str());
+        return failed;
+    }
 }
 
 #endif
@@ -0,0 +1,236 @@
+// Dear emacs, this is -*- c++ -*-
+// vim: ts=2 sw=2
+// $Id$
+
+// System include(s):
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <set>
+#include <string>
+
+// ROOT include(s):
+#include <TChain.h>
+#include <TFile.h>
+#include <TError.h>
+#include <TSystem.h>
+#include <TH1.h>
+
+// Core EDM include(s):
+#include "AthContainers/AuxElement.h"
+#include "AthContainers/DataVector.h"
+
+// EDM includes
+#include "xAODBase/IParticle.h"
+#include "xAODEventInfo/EventInfo.h"
+#include "xAODJet/JetContainer.h"
+#include "xAODTau/TauJetContainer.h"
+#include "xAODEgamma/ElectronContainer.h"
+#include "xAODMuon/MuonContainer.h"
+#include "xAODCore/AuxContainerBase.h"
+
+// ROOT ACCESS Includes
+#include "xAODRootAccess/Init.h"
+#include "xAODRootAccess/TEvent.h"
+#include "xAODRootAccess/tools/ReturnCheck.h"
+
+// tools
+#include "AssociationUtils/OverlapRemovalTool.h"
+#include "TauAnalysisTools/TauSelectionTool.h"
+#include "TauAnalysisTools/TauTruthMatchingTool.h"
+#include "TrigTauMatching/TrigTauMatching.h"
+#include "MuonSelectorTools/MuonSelectionTool.h"
+#include "ElectronPhotonSelectorTools/AsgElectronLikelihoodTool.h"
+
+// Trigger Decision Tool
+#include "TrigConfxAOD/xAODConfigTool.h"
+#include "TrigDecisionTool/TrigDecisionTool.h"
+
+
+// Local stuff
+#include "TriggerValidation/AcceptanceSelections.h"
+#include "TriggerValidation/EffCurvesTool.h"
+#include "TriggerValidation/EventArena.h"
+#include "TriggerValidation/Utils.h"
+
+// run both channel selections over the entries [first, last), the tools are
+// shared by the two channels, and write the result to fout_name
+int process(int worker, const std::vector<std::string>& filenames, const std::vector<std::string>& hh_triggers,
+	    const std::vector<std::string>& lh_triggers, Long64_t first, Long64_t last, const std::string& fout_name) {
+
+  const char* APP_NAME = "acceptance_combined";
+
+  // Create the TEvent object
+  xAOD::TEvent event(xAOD::TEvent::kClassAccess);
+  xAOD::TStore store;
+
+  ::TChain chain1("CollectionTree");
+  for(auto fname : filenames){
+    chain1.Add(fname.c_str());
+  }
+
+  RETURN_CHECK(APP_NAME, event.readFrom(&chain1));
+
+  //Set up TDT 
+  TrigConf::xAODConfigTool configTool("TrigConf::xAODConfigTool");
+  ToolHandle<TrigConf::ITrigConfigTool> configHandle(&configTool);
+  CHECK(configHandle->initialize());
+
+  // The decision tool
+  Trig::TrigDecisionTool trigDecTool("TrigDecTool");
+  CHECK(trigDecTool.setProperty("ConfigTool",configHandle));
+  CHECK(trigDecTool.setProperty("TrigDecisionKey","xTrigDecision"));
+  CHECK(trigDecTool.initialize());
+
+  // Muon Selector Tool
+  CP::MuonSelectionTool muonSelector("muonSelector");
+  CHECK(muonSelector.setProperty("MaxEta", 2.5));
+  CHECK(muonSelector.initialize());
+
+  // Create and configure the tool
+  OverlapRemovalTool orTool("OverlapRemovalTool");
+  // Initialize the tool
+  CHECK( orTool.initialize() );
+
+  // Tau Truth Matching Tool
+  TauAnalysisTools::TauTruthMatchingTool truthMatchTool("truthMatchTool");
+  CHECK(truthMatchTool.initialize());
+
+  // Tau Selection Tool
+  TauAnalysisTools::TauSelectionTool tauSelector("tauSelector");
+  CHECK(tauSelector.initialize());
+
+  // TrigTau matching tool
+  Trig::TrigTauMatchingTool trigTauMatchingTool("TrigTauMatchingTool");
+  CHECK(trigTauMatchingTool.setProperty("TrigDecisionTool", ToolHandle<Trig::TrigDecisionTool>(&trigDecTool)));
+  CHECK(trigTauMatchingTool.setProperty("HLTLabel", "TrigTauRecMerged"));
+  CHECK(trigTauMatchingTool.initialize());
+
+  // the two channels share the tools
+  AcceptanceChannel hh("hh", hh_triggers);
+  AcceptanceChannel lh("lh", lh_triggers);
+  HadHadSelection hadhad(trigDecTool, trigTauMatchingTool, truthMatchTool, orTool);
+  LepHadSelection lephad(trigDecTool, trigTauMatchingTool, truthMatchTool, muonSelector, tauSelector);
+
+  // per-event selection views
+  EventArena arena;
+
+  // the EDM objects of the current event
+  const xAOD::TauJetContainer* taus = 0;
+  const xAOD::JetContainer* jets = 0;
+  const xAOD::ElectronContainer* electrons = 0;
+  const xAOD::MuonContainer* muons = 0;
+
+  for (Long64_t entry = first; entry < last; entry++) {
+     if ((entry%200)==0)
+       ::Info(APP_NAME, "Worker %d: start processing event %d", worker, (int)entry);
+
+    event.getEntry(entry);
+    arena.reset();
+    hh.reset();
+    lh.reset();
+
+    // retrieve the EDM objects, once for both channels
+    CHECK(event.retrieve(taus, "TauJets"));
+    CHECK(event.retrieve(jets, "AntiKt4LCTopoJets"));
+    CHECK(event.retrieve(electrons, "Electrons"));
+    CHECK(event.retrieve(muons, "Muons"));
+
+    CHECK(truthMatchTool.initializeEvent());
+
+    // the two selections are independent, they only share the tools and
+    // the input containers
+    if (hadhad.execute(taus, jets, arena, hh) != 0)
+      return 1;
+    lephad.execute(taus, electrons, muons, arena, lh);
+
+  } // loop over all the events
+
+  // same content as the acceptance_hh and acceptance_lh outputs, in the
+  // hh/ and lh/ directories
+  TFile fout(fout_name.c_str(), "RECREATE");
+  hh.write(fout.mkdir(hh.name.c_str()));
+  lh.write(fout.mkdir(lh.name.c_str()));
+  fout.Close();
+
+  return 0;
+}
+
+
+int main(int argc, char **argv) {
+
+
+  // Get the name of the application:
+  const char* APP_NAME = "acceptance_combined";
+
+  // Initialise the environment:
+  RETURN_CHECK( APP_NAME, xAOD::Init( APP_NAME ) );
+
+  static const char* FNAME = 
+    "/afs/cern.ch/user/q/qbuat/work/public/"
+    "mc15_13TeV/mc15_13TeV.341124.PowhegPythia8EvtGen_CT10_AZNLOCTEQ6L1_ggH125_tautauhh."
+    "merge.AOD.e3935_s2608_s2183_r6630_r6264/AOD.05569772._000004.pool.root.1";
+ 
+  std::vector<std::string> filenames;
+  if(argc < 2){
+    filenames.push_back(std::string(FNAME));
+  } else {
+    filenames = Utils::splitNames(argv[1]);
+  }
+
+  // number of worker processes
+  int nprocs = 1;
+  if (argc > 2)
+    nprocs = std::max(1, atoi(argv[2]));
+
+  std::vector<std::string> hh_triggers;
+  // hh_triggers.push_back("L1_TAU12");
+  // hh_triggers.push_back("L1_TAU60");
+  // hh_triggers.push_back("L1_TAU20_2TAU12");
+  // hh_triggers.push_back("L1_TAU20IM_2TAU12IM");
+  // hh_triggers.push_back("L1_TAU20ITAU12I-J25");
+  // hh_triggers.push_back("L1_TAU20IM_2TAU12IM_J25_2J20_3J12");
+  // hh_triggers.push_back("L1_J25_2J20_3J12_DR-TAU20ITAU12I");
+  // hh_triggers.push_back("L1_DR-TAU20ITAU12I");
+  // hh_triggers.push_back("L1_DR-TAU20ITAU12I-J25");
+  hh_triggers.push_back("HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM");
+  hh_triggers.push_back("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo_L1TAU20IM_2TAU12IM");
+  hh_triggers.push_back("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo");
+  hh_triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo_L1TAU20IM_2TAU12IM");
+  hh_triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo_L1DR-TAU20ITAU12I-J25");
+  hh_triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo");
+  hh_triggers.push_back("HLT_tau35_tight1_tracktwo_tau25_tight1_tracktwo");
+  
+  std::vector<std::string> lh_triggers;
+  lh_triggers.push_back("HLT_tau25_perf_ptonly");
+  lh_triggers.push_back("HLT_tau25_medium1_ptonly");
+  lh_triggers.push_back("HLT_tau25_perf_tracktwo");
+  lh_triggers.push_back("HLT_tau25_medium1_tracktwo");
+
+  // the stages of an event are filled from one 64 bit mask
+  if (not AcceptanceChannel::fits(hh_triggers) or not AcceptanceChannel::fits(lh_triggers)) {
+    ::Error(APP_NAME, "too many triggers, at most %d slots per channel", (int)EffCurvesTool::MAX_SLOTS);
+    return 1;
+  }
+
+
+  // the input files are closed again before forking
+  Long64_t entries = 0;
+  {
+    ::TChain chain("CollectionTree");
+    for(auto fname : filenames){
+      chain.Add(fname.c_str());
+    }
+    entries = chain.GetEntries();
+  }
+
+  // each worker process gets a contiguous range of entries, the partial
+  // outputs are merged into acceptance.root
+  if (nprocs > 1)
+    ::Info(APP_NAME, "Processing %d events with %d processes", (int)entries, nprocs);
+
+  return Utils::forkRanges(entries, nprocs, "acceptance.root",
+			   [&](int worker, Long64_t first, Long64_t last, const std::string& fout_name) {
+			     return process(worker, filenames, hh_triggers, lh_triggers, first, last, fout_name);
+			   });
+}
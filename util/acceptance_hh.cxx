@@ -3,6 +3,8 @@
 // $Id$
 
 // System include(s):
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <set>
 #include <string>
@@ -45,7 +47,9 @@
 #include "TrigDecisionTool/TrigDecisionTool.h"
 
 // Local stuff
+#include "TriggerValidation/AcceptanceSelections.h"
 #include "TriggerValidation/EffCurvesTool.h"
+#include "TriggerValidation/EventArena.h"
 #include "TriggerValidation/Utils.h"
 
 
@@ -53,28 +57,13 @@ using namespace TrigConf;
 using namespace Trig;
 
 
+// run the selection over the entries [first, last) and write the result to
+// fout_name
+int process(int worker, const std::vector<std::string>& filenames, const std::vector<std::string>& triggers,
+	    Long64_t first, Long64_t last, const std::string& fout_name) {
 
-int main(int argc, char **argv) {
-
-
-  // Get the name of the application:
   const char* APP_NAME = "acceptance";
 
-  // Initialise the environment:
-  RETURN_CHECK(APP_NAME, xAOD::Init(APP_NAME));
-
-  static const char* FNAME = 
-    "/afs/cern.ch/user/q/qbuat/work/public/"
-    "mc15_13TeV/mc15_13TeV.341124.PowhegPythia8EvtGen_CT10_AZNLOCTEQ6L1_ggH125_tautauhh."
-    "merge.AOD.e3935_s2608_s2183_r6630_r6264/AOD.05569772._000004.pool.root.1";
- 
-  std::vector<std::string> filenames;
-  if(argc < 2){
-    filenames.push_back(std::string(FNAME));
-  } else {
-    filenames = Utils::splitNames(argv[1]);
-  }
-
   // Create the TEvent object
   xAOD::TEvent event(xAOD::TEvent::kClassAccess);
   xAOD::TStore store;
@@ -116,46 +105,20 @@ int main(int argc, char **argv) {
   CHECK(trigTauMatchingTool.setProperty("HLTLabel", "TrigTauRecMerged"));
   CHECK(trigTauMatchingTool.initialize());
 
-  std::vector<std::string> triggers;
-  // triggers.push_back("L1_TAU12");
-  // triggers.push_back("L1_TAU60");
-  // triggers.push_back("L1_TAU20_2TAU12");
-  // triggers.push_back("L1_TAU20IM_2TAU12IM");
-  // triggers.push_back("L1_TAU20ITAU12I-J25");
-  // triggers.push_back("L1_TAU20IM_2TAU12IM_J25_2J20_3J12");
-  // triggers.push_back("L1_J25_2J20_3J12_DR-TAU20ITAU12I");
-  // triggers.push_back("L1_DR-TAU20ITAU12I");
-  // triggers.push_back("L1_DR-TAU20ITAU12I-J25");
-  triggers.push_back("HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM");
-  triggers.push_back("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo_L1TAU20IM_2TAU12IM");
-  triggers.push_back("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo");
-  triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo_L1TAU20IM_2TAU12IM");
-  triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo_L1DR-TAU20ITAU12I-J25");
-  triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo");
-  triggers.push_back("HLT_tau35_tight1_tracktwo_tau25_tight1_tracktwo");
-  
-  TH1F h("h_acceptance", "h_acceptance", triggers.size() + 1, 0, 1);
-  h.GetXaxis()->SetBinLabel(1, "notrigger");
-  for (int ib=0; ib < h.GetNbinsX() - 1; ib++)
-    h.GetXaxis()->SetBinLabel(ib + 2, triggers[ib].c_str());
-
-  std::map<std::string, EffCurvesTool*> curves_tools_nopt;
-  std::map<std::string, EffCurvesTool*> curves_tools_nodr;
-  std::map<std::string, EffCurvesTool*> curves_tools_final;
-  for (auto trig: triggers) {
-    curves_tools_nopt[trig] = new EffCurvesTool(trig + "_nopt");
-    curves_tools_nodr[trig] = new EffCurvesTool(trig + "_nodr");
-    curves_tools_final[trig] = new EffCurvesTool(trig + "_final");
-  }
-
+  // hadhad selection, trigger decisions and curves
+  AcceptanceChannel hh("hh", triggers);
+  HadHadSelection hadhad(trigDecTool, trigTauMatchingTool, truthMatchTool, orTool);
 
+  // per-event selection views
+  EventArena arena;
 
-  Long64_t entries = event.getEntries();
-  for (Long64_t entry = 0; entry < entries; entry++) {
+  for (Long64_t entry = first; entry < last; entry++) {
      if ((entry%200)==0)
-       ::Info(APP_NAME, "Start processing event %d", (int)entry);
+       ::Info(APP_NAME, "Worker %d: start processing event %d", worker, (int)entry);
 
     event.getEntry(entry);
+    arena.reset();
+    hh.reset();
 
     // retrieve the EDM objects
     const xAOD::EventInfo * ei = 0;
@@ -170,179 +133,88 @@ int main(int argc, char **argv) {
 
     CHECK(truthMatchTool.initializeEvent());
 
-    xAOD::TauJetContainer* selected_taus = new xAOD::TauJetContainer();
-    xAOD::AuxContainerBase* selected_taus_aux = new xAOD::AuxContainerBase();
-    selected_taus->setStore(selected_taus_aux);
-
-    for (const auto tau: *taus) {
-
-      // // pt cut
-      // if (tau->pt() < 30000.) 
-      // 	continue;
-      // eta cut
-      if (fabs(tau->eta()) > 2.5)
-	continue;
-
-      if (fabs(tau->eta()) > 1.37 and fabs(tau->eta()) < 1.52)
-	continue;
-      
-      // 1 or 3 tracks
-      if (tau->nTracks() != 1 and tau->nTracks() != 3)
-	continue;
-
-      // ID cut
-      if (not tau->isTau(xAOD::TauJetParameters::JetBDTSigMedium))
-	continue;
-      
-      selectDec(*tau) = true;
-      xAOD::TauJet * new_tau = new xAOD::TauJet();
-      new_tau->makePrivateStore(*tau);
-      selected_taus->push_back(new_tau);
-    }
-
-    if (selected_taus->size() < 2)
-      continue;
-
-    selected_taus->sort(Utils::comparePt);
+    if (hadhad.execute(taus, jets, arena, hh) != 0)
+      return 1;
 
-    xAOD::TauJet* tau1 = selected_taus->at(0);
-    xAOD::TauJet* tau2 = selected_taus->at(1);
-
-    auto* truth_tau1 = truthMatchTool.applyTruthMatch(*tau1);
-    auto* truth_tau2 = truthMatchTool.applyTruthMatch(*tau2);
-
-    if (truth_tau1 == NULL or truth_tau2 == NULL)
-      continue;
+  } // loop over all the events
 
-    for (const auto jet: *jets)
-      selectDec(*jet) = true;
-    // tau - jet overlap removal
-    CHECK(orTool.removeTauJetOverlap(*selected_taus, *jets));
+  TFile fout(fout_name.c_str(), "RECREATE");
+  hh.write(&fout);
+  fout.Close();
 
-    xAOD::JetContainer* selected_jets = new xAOD::JetContainer();
-    xAOD::AuxContainerBase* selected_jets_aux = new xAOD::AuxContainerBase();
-    selected_jets->setStore(selected_jets_aux);
+  return 0;
+}
 
-    for (const auto jet: *jets) {
-      
-      // // pt cut
-      // if (jet->pt() < 50000.) 
-      // 	continue;
 
-      if (fabs(jet->eta()) > 3.2)
-	continue;
 
-      if (overlapAcc(*jet))
-	continue;
+int main(int argc, char **argv) {
 
-      xAOD::Jet* new_jet = new xAOD::Jet();
-      new_jet->makePrivateStore(*jet);
-      selected_jets->push_back(new_jet);
-    }
 
-    if (selected_jets->size() < 1)
-      continue;
+  // Get the name of the application:
+  const char* APP_NAME = "acceptance";
 
-    selected_jets->sort(Utils::comparePt);
+  // Initialise the environment:
+  RETURN_CHECK(APP_NAME, xAOD::Init(APP_NAME));
 
-    for (auto trig: triggers) {
-      bool pass = trigDecTool.isPassed(trig) and trigTauMatchingTool.match(tau1, trig) and trigTauMatchingTool.match(tau2, trig);
-      curves_tools_nopt[trig]->fill_hadhad(pass, tau1, tau2, selected_jets->at(0));
-    }
-    
-    if (tau1->pt() < 40000. or tau2->pt() < 30000. or selected_jets->at(0)->pt() < 60000.)
-      continue;
+  static const char* FNAME = 
+    "/afs/cern.ch/user/q/qbuat/work/public/"
+    "mc15_13TeV/mc15_13TeV.341124.PowhegPythia8EvtGen_CT10_AZNLOCTEQ6L1_ggH125_tautauhh."
+    "merge.AOD.e3935_s2608_s2183_r6630_r6264/AOD.05569772._000004.pool.root.1";
+ 
+  std::vector<std::string> filenames;
+  if(argc < 2){
+    filenames.push_back(std::string(FNAME));
+  } else {
+    filenames = Utils::splitNames(argv[1]);
+  }
 
-    for (auto trig: triggers) {
-      bool pass = trigDecTool.isPassed(trig) and trigTauMatchingTool.match(tau1, trig) and trigTauMatchingTool.match(tau2, trig);
-	curves_tools_nodr[trig]->fill_hadhad(pass, tau1, tau2, selected_jets->at(0));
-    }
+  // number of worker processes
+  int nprocs = 1;
+  if (argc > 2)
+    nprocs = std::max(1, atoi(argv[2]));
 
-    double delta_r = tau1->p4().DeltaR(tau2->p4());
-    if (delta_r < 0.8 or delta_r > 2.4)
-      continue;
+  std::vector<std::string> triggers;
+  // triggers.push_back("L1_TAU12");
+  // triggers.push_back("L1_TAU60");
+  // triggers.push_back("L1_TAU20_2TAU12");
+  // triggers.push_back("L1_TAU20IM_2TAU12IM");
+  // triggers.push_back("L1_TAU20ITAU12I-J25");
+  // triggers.push_back("L1_TAU20IM_2TAU12IM_J25_2J20_3J12");
+  // triggers.push_back("L1_J25_2J20_3J12_DR-TAU20ITAU12I");
+  // triggers.push_back("L1_DR-TAU20ITAU12I");
+  // triggers.push_back("L1_DR-TAU20ITAU12I-J25");
+  triggers.push_back("HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM");
+  triggers.push_back("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo_L1TAU20IM_2TAU12IM");
+  triggers.push_back("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo");
+  triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo_L1TAU20IM_2TAU12IM");
+  triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo_L1DR-TAU20ITAU12I-J25");
+  triggers.push_back("HLT_tau35_medium1_tracktwo_tau25_medium1_tracktwo");
+  triggers.push_back("HLT_tau35_tight1_tracktwo_tau25_tight1_tracktwo");
+  
+  // the stages of an event are filled from one 64 bit mask
+  if (not AcceptanceChannel::fits(triggers)) {
+    ::Error(APP_NAME, "%d triggers x 3 stages do not fit in %d slots", (int)triggers.size(),
+	    (int)EffCurvesTool::MAX_SLOTS);
+    return 1;
+  }
 
-    h.Fill("notrigger", 1);
-    for (auto trig: triggers) {
-      bool pass = trigDecTool.isPassed(trig) and trigTauMatchingTool.match(tau1, trig) and trigTauMatchingTool.match(tau2, trig);
-      curves_tools_final[trig]->fill_hadhad(pass, tau1, tau2, selected_jets->at(0));
-      if (pass) 
-	h.Fill(trig.c_str(), 1);
+  // the input files are closed again before forking
+  Long64_t entries = 0;
+  {
+    ::TChain chain("CollectionTree");
+    for(auto fname : filenames){
+      chain.Add(fname.c_str());
     }
+    entries = chain.GetEntries();
+  }
 
+  // each worker process gets a contiguous range of entries, the partial
+  // outputs are merged into acceptance.root
+  if (nprocs > 1)
+    ::Info(APP_NAME, "Processing %d events with %d processes", (int)entries, nprocs);
 
-    // if (not trigDecTool.isPassed("HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo_L1TAU20IM_2TAU12IM") and \
-    // 	trigDecTool.isPassed("HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM")) {
-    //   std::cout << " " <<  std::endl;
-    //   std::cout << "-----------------------" <<  std::endl;
-    //   std::cout << "Entry = " << entry 
-    // 		<< ", RunNumber = " << ei->runNumber() 
-    // 		<< " , EventNumber = " << ei->eventNumber() << std::endl;
-    //   std::cout << "Not pass HLT_tau35_loose1_tracktwo_tau25_loose1_tracktwo_L1TAU20IM_2TAU12IM but pass " \
-    // 	"HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM" << std::endl;
-    //   std::cout << "pt | eta | phi | nTracks | mediumid" << std::endl;
-    //   std::cout << "-- offline -- " << std::endl;
-    //   std::cout << tau1->pt() << " | " 
-    // 		<< tau1->eta() << " | " 
-    // 		<< tau1->phi() << " | " 
-    // 		<< tau1->nTracks() << " | "
-    // 		<< tau1->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
-    // 		<< std::endl;
-    //   std::cout << tau2->pt() << " | " 
-    // 		<< tau2->eta() << " | " 
-    // 		<< tau2->phi() << " | " 
-    // 		<< tau2->nTracks() << " | "
-    // 		<< tau2->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
-    // 		<< std::endl;
-    //   std::cout << "-- truth -- " << std::endl;
-    //   std::cout << truth_tau1->auxdataConst<double>("pt_vis") << " | " 
-    // 		<< truth_tau1->auxdataConst<double>("eta_vis") << " | " 
-    // 		<< truth_tau1->auxdataConst<double>("phi_vis") << " | " 
-    // 		// << tau1->nTracks() << " | "
-    // 		// << tau1->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
-    // 		<< std::endl;
-    //   std::cout << truth_tau2->auxdataConst<double>("pt_vis") << " | " 
-    // 		<< truth_tau2->auxdataConst<double>("eta_vis") << " | " 
-    // 		<< truth_tau2->auxdataConst<double>("phi_vis") << " | " 
-    // 		// << tau1->nTracks() << " | "
-    // 		// << tau1->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
-    // 		<< std::endl;
-    //   std::cout <<  " -- hlt features -- " << std::endl;
-    //   auto cg = trigDecTool.getChainGroup("HLT_tau35_perf_ptonly_tau25_perf_ptonly_L1TAU20IM_2TAU12IM");
-    //   auto features = cg->features();
-    //   auto tauHltFeatures = features.containerFeature<xAOD::TauJetContainer>("TrigTauRecMerged");
-    //   for (auto &tauContainer: tauHltFeatures) {
-    // 	if (tauContainer.cptr()) {
-    // 	  for (auto tau: *tauContainer.cptr()) {
-    // 	    std::cout << tau->pt() << " | " 
-    // 		      << tau->eta() << " | " 
-    // 		      << tau->phi() << " | " 
-    // 		      << tau->nTracks() << " | "
-    // 		      << tau->isTau(xAOD::TauJetParameters::JetBDTSigMedium)
-    // 		      << std::endl;
-    // 	  }
-    // 	}
-    //   }
-    //   std::cout << "-----------------------" <<  std::endl;
-    //   std::cout << " " <<  std::endl;
-
-    // }
-
-  } // loop over all the events
-
-
-  TFile fout("acceptance.root", "RECREATE");
-  h.Write();
-  for (auto it: curves_tools_nopt) 
-    for (auto tool: (it.second)->Efficiencies()) 
-      (tool.second)->Write();
-  for (auto it: curves_tools_nodr) 
-    for (auto tool: (it.second)->Efficiencies()) 
-      (tool.second)->Write();
-  for (auto it: curves_tools_final) 
-    for (auto tool: (it.second)->Efficiencies()) 
-      (tool.second)->Write();
-  fout.Close();
-
+  return Utils::forkRanges(entries, nprocs, "acceptance.root",
+			   [&](int worker, Long64_t first, Long64_t last, const std::string& fout_name) {
+			     return process(worker, filenames, triggers, first, last, fout_name);
+			   });
 }
-
@@ -3,6 +3,8 @@
 // $Id$
 
 // System include(s):
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <set>
 #include <string>
@@ -46,30 +48,18 @@
 
 
 // Local stuff
+#include "TriggerValidation/AcceptanceSelections.h"
 #include "TriggerValidation/EffCurvesTool.h"
+#include "TriggerValidation/EventArena.h"
 #include "TriggerValidation/Utils.h"
 
-int main(int argc, char **argv) {
-
+// run the selection over the entries [first, last) and write the result to
+// fout_name
+int process(int worker, const std::vector<std::string>& filenames, const std::vector<std::string>& triggers,
+	    Long64_t first, Long64_t last, const std::string& fout_name) {
 
-  // Get the name of the application:
   const char* APP_NAME = "acceptance_lh";
 
-  // Initialise the environment:
-  RETURN_CHECK( APP_NAME, xAOD::Init( APP_NAME ) );
-
-  static const char* FNAME = 
-    "/afs/cern.ch/user/q/qbuat/work/public/"
-    "mc15_13TeV/mc15_13TeV.341124.PowhegPythia8EvtGen_CT10_AZNLOCTEQ6L1_ggH125_tautauhh."
-    "merge.AOD.e3935_s2608_s2183_r6630_r6264/AOD.05569772._000004.pool.root.1";
- 
-  std::vector<std::string> filenames;
-  if(argc < 2){
-    filenames.push_back(std::string(FNAME));
-  } else {
-    filenames = Utils::splitNames(argv[1]);
-  }
-
   // Create the TEvent object
   xAOD::TEvent event(xAOD::TEvent::kClassAccess);
   xAOD::TStore store;
@@ -120,34 +110,21 @@ int main(int argc, char **argv) {
   CHECK(trigTauMatchingTool.setProperty("HLTLabel", "TrigTauRecMerged"));
   CHECK(trigTauMatchingTool.initialize());
 
-  std::vector<std::string> triggers;
-  triggers.push_back("HLT_tau25_perf_ptonly");
-  triggers.push_back("HLT_tau25_medium1_ptonly");
-  triggers.push_back("HLT_tau25_perf_tracktwo");
-  triggers.push_back("HLT_tau25_medium1_tracktwo");
-
-
-  TH1F h("h_acceptance", "h_acceptance", triggers.size() + 1, 0, 1);
-  h.GetXaxis()->SetBinLabel(1, "notrigger");
-  for (int ib=0; ib < h.GetNbinsX() - 1; ib++)
-    h.GetXaxis()->SetBinLabel(ib + 2, triggers[ib].c_str());
+  // lephad selection, trigger decisions and curves
+  AcceptanceChannel lh("lh", triggers);
+  LepHadSelection lephad(trigDecTool, trigTauMatchingTool, truthMatchTool, muonSelector, tauSelector);
 
-  std::map<std::string, EffCurvesTool*> curves_tools_nopt;
-  std::map<std::string, EffCurvesTool*> curves_tools_nodr;
-  std::map<std::string, EffCurvesTool*> curves_tools_final;
-  for (auto trig: triggers) {
-    curves_tools_nopt[trig] = new EffCurvesTool(trig + "_nopt");
-    curves_tools_nodr[trig] = new EffCurvesTool(trig + "_nodr");
-    curves_tools_final[trig] = new EffCurvesTool(trig + "_final");
-  }
+  // per-event selection views
+  EventArena arena;
 
-  Long64_t entries = event.getEntries();
-  for (Long64_t entry = 0; entry < entries; entry++) {
+  for (Long64_t entry = first; entry < last; entry++) {
      if ((entry%200)==0)
-       ::Info(APP_NAME, "Start processing event %d", (int)entry);
+       ::Info(APP_NAME, "Worker %d: start processing event %d", worker, (int)entry);
     // ::Info(APP_NAME, "Start processing event %d", (int)entry);
 
     event.getEntry(entry);
+    arena.reset();
+    lh.reset();
 
     // retrieve the EDM objects
     const xAOD::EventInfo * ei = 0;
@@ -167,124 +144,76 @@ int main(int argc, char **argv) {
 
     CHECK(truthMatchTool.initializeEvent());
 
+    lephad.execute(taus, electrons, muons, arena, lh);
 
-    // ---->>>   Muons 
-    xAOD::MuonContainer* selected_muons = new xAOD::MuonContainer();
-    xAOD::AuxContainerBase* selected_muons_aux = new xAOD::AuxContainerBase();
-    selected_muons->setStore(selected_muons_aux);
-
-    for (const auto muon: *muons) {
-      if (not muonSelector.accept(muon))
-	continue;
-      selectDec(*muon) = true;
-      xAOD::Muon * new_muon = new xAOD::Muon();
-      new_muon->makePrivateStore(*muon);
-      selected_muons->push_back(new_muon);
-    }
-    selected_muons->sort(Utils::comparePt);
-    // ------------------
-
-    // ---->>> Electrons 
-    xAOD::ElectronContainer* selected_electrons = new xAOD::ElectronContainer();
-    xAOD::AuxContainerBase* selected_electrons_aux = new xAOD::AuxContainerBase();
-    selected_electrons->setStore(selected_electrons_aux);
-
-    for (const auto electron: *electrons) {
-      // if (not electronSelector.accept(electron))
-      // 	continue;
-      selectDec(*electron) = true;
-      xAOD::Electron * new_electron = new xAOD::Electron();
-      new_electron->makePrivateStore(*electron);
-      selected_electrons->push_back(new_electron);
-    }
-    selected_electrons->sort(Utils::comparePt);
-    // ------------------
-
-    if (selected_muons->size() < 1 or selected_electrons->size() < 1)
-      continue;
-
-    // ---->>>   Taus 
-    xAOD::TauJetContainer* selected_taus = new xAOD::TauJetContainer();
-    xAOD::AuxContainerBase* selected_taus_aux = new xAOD::AuxContainerBase();
-    selected_taus->setStore(selected_taus_aux);
-
-    for (const auto tau: *taus) {
-      if (not tauSelector.accept(tau))
-	continue;
-      selectDec(*tau) = true;
-      xAOD::TauJet * new_tau = new xAOD::TauJet();
-      new_tau->makePrivateStore(*tau);
-      selected_taus->push_back(new_tau);
-    }
-    if (selected_taus->size() < 1)
-      continue;
-
-    selected_taus->sort(Utils::comparePt);
-    xAOD::TauJet* tau1 = selected_taus->at(0);
-
-      
-    
+  } // loop over all the events
 
+  TFile fout(fout_name.c_str(), "RECREATE");
+  lh.write(&fout);
+  fout.Close();
 
-    auto* truth_tau1 = truthMatchTool.applyTruthMatch(*tau1);
-    if (truth_tau1 == NULL)
-      continue;
-    // --------------
+  return 0;
+}
 
-    for (auto trig: triggers) {
-      bool pass = trigDecTool.isPassed(trig) and trigTauMatchingTool.match(tau1, trig);
-      curves_tools_nopt[trig]->fill_lephad(pass, tau1);
-    }
 
-    if (tau1->pt() < 25000.)
-      continue;
-    
-    h.Fill("notrigger", 1);
-    for (auto trig: triggers) {
-      bool pass = trigDecTool.isPassed(trig) and trigTauMatchingTool.match(tau1, trig);
-      curves_tools_final[trig]->fill_lephad(pass, tau1);
-      if (pass) 
-	h.Fill(trig.c_str(), 1);
-    }
+int main(int argc, char **argv) {
 
 
-    // // ---->>> Jets
-    // xAOD::JetContainer* selected_jets = new xAOD::JetContainer();
-    // xAOD::AuxContainerBase* selected_jets_aux = new xAOD::AuxContainerBase();
-    // selected_jets->setStore(selected_jets_aux);
-    // for (const auto jet: *jets) {
-    //   selectDec(*jet) = true;
-    //   xAOD::Jet* new_jet = new xAOD::Jet();
-    //   new_jet->makePrivateStore(*jet);
-    //   selected_jets->push_back(new_jet);
-    // }
+  // Get the name of the application:
+  const char* APP_NAME = "acceptance_lh";
 
-    // if (selected_jets->size() < 1)
-    //   continue;
+  // Initialise the environment:
+  RETURN_CHECK( APP_NAME, xAOD::Init( APP_NAME ) );
 
-    // selected_jets->sort(Utils::comparePt);
-    // // --------------
+  static const char* FNAME = 
+    "/afs/cern.ch/user/q/qbuat/work/public/"
+    "mc15_13TeV/mc15_13TeV.341124.PowhegPythia8EvtGen_CT10_AZNLOCTEQ6L1_ggH125_tautauhh."
+    "merge.AOD.e3935_s2608_s2183_r6630_r6264/AOD.05569772._000004.pool.root.1";
+ 
+  std::vector<std::string> filenames;
+  if(argc < 2){
+    filenames.push_back(std::string(FNAME));
+  } else {
+    filenames = Utils::splitNames(argv[1]);
+  }
 
-    // // tau - jet overlap removal
-    // CHECK(orTool.removeOverlaps(selected_electrons, selected_muons, selected_jets, selected_taus));
+  // number of worker processes
+  int nprocs = 1;
+  if (argc > 2)
+    nprocs = std::max(1, atoi(argv[2]));
 
+  std::vector<std::string> triggers;
+  triggers.push_back("HLT_tau25_perf_ptonly");
+  triggers.push_back("HLT_tau25_medium1_ptonly");
+  triggers.push_back("HLT_tau25_perf_tracktwo");
+  triggers.push_back("HLT_tau25_medium1_tracktwo");
 
 
-  } // loop over all the events
+  // the stages of an event are filled from one 64 bit mask (there is no
+  // delta r cut here, the nodr curves stay empty)
+  if (not AcceptanceChannel::fits(triggers)) {
+    ::Error(APP_NAME, "%d triggers x 3 stages do not fit in %d slots", (int)triggers.size(),
+	    (int)EffCurvesTool::MAX_SLOTS);
+    return 1;
+  }
 
+  // the input files are closed again before forking
+  Long64_t entries = 0;
+  {
+    ::TChain chain("CollectionTree");
+    for(auto fname : filenames){
+      chain.Add(fname.c_str());
+    }
+    entries = chain.GetEntries();
+  }
 
-  TFile fout("acceptance.root", "RECREATE");
-  h.Write();
-  for (auto it: curves_tools_nopt) 
-    for (auto tool: (it.second)->Efficiencies()) 
-      (tool.second)->Write();
-  for (auto it: curves_tools_nodr) 
-    for (auto tool: (it.second)->Efficiencies()) 
-      (tool.second)->Write();
-  for (auto it: curves_tools_final) 
-    for (auto tool: (it.second)->Efficiencies()) 
-      (tool.second)->Write();
-  fout.Close();
+  // each worker process gets a contiguous range of entries, the partial
+  // outputs are merged into acceptance.root
+  if (nprocs > 1)
+    ::Info(APP_NAME, "Processing %d events with %d processes", (int)entries, nprocs);
 
+  return Utils::forkRanges(entries, nprocs, "acceptance.root",
+			   [&](int worker, Long64_t first, Long64_t last, const std::string& fout_name) {
+			     return process(worker, filenames, triggers, first, last, fout_name);
+			   });
 }
-
@@ -0,0 +1,185 @@
+// Dear emacs, this is -*- c++ -*-
+// vim: ts=2 sw=2
+// $Id$
+
+// Benchmark of the tau - jet overlap removal: per-pair
+// TLorentzVector::DeltaR against the DeltaRMatcher grid, as in
+// AcceptanceHadHadTDR::select_jets (cone 0.4 by default). Exits non zero if
+// the two disagree on any jet. OverlapRemovalTool removeTauJetOverlap, with
+// its own rapidity based cone, is timed and compared for information only.
+// usage: benchmark_deltar [files] [cone] [repetitions]
+
+// System include(s):
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// ROOT include(s):
+#include <TChain.h>
+#include <TError.h>
+
+// EDM includes
+#include "xAODJet/JetContainer.h"
+#include "xAODTau/TauJetContainer.h"
+
+// ROOT ACCESS Includes
+#include "xAODRootAccess/Init.h"
+#include "xAODRootAccess/TEvent.h"
+#include "xAODRootAccess/tools/ReturnCheck.h"
+
+// tools
+#include "AssociationUtils/OverlapRemovalTool.h"
+
+// Local stuff
+#include "TriggerValidation/DeltaRMatcher.h"
+#include "TriggerValidation/Utils.h"
+
+
+int main(int argc, char **argv) {
+
+  // Get the name of the application:
+  const char* APP_NAME = "benchmark_deltar";
+
+  // Initialise the environment:
+  RETURN_CHECK(APP_NAME, xAOD::Init(APP_NAME));
+
+  static const char* FNAME =
+    "/afs/cern.ch/user/q/qbuat/work/public/"
+    "mc15_13TeV/mc15_13TeV.341124.PowhegPythia8EvtGen_CT10_AZNLOCTEQ6L1_ggH125_tautauhh."
+    "merge.AOD.e3935_s2608_s2183_r6630_r6264/AOD.05569772._000004.pool.root.1";
+
+  std::vector<std::string> filenames;
+  if(argc < 2){
+    filenames.push_back(std::string(FNAME));
+  } else {
+    filenames = Utils::splitNames(argv[1]);
+  }
+
+  double cone = 0.4;
+  if (argc > 2)
+    cone = atof(argv[2]);
+
+  // the queries of an event are repeated to get measurable times
+  int repetitions = 100;
+  if (argc > 3)
+    repetitions = std::max(1, atoi(argv[3]));
+
+  // Create the TEvent object
+  xAOD::TEvent event(xAOD::TEvent::kClassAccess);
+
+  ::TChain chain1("CollectionTree");
+  for(auto fname : filenames){
+    chain1.Add(fname.c_str());
+  }
+
+  RETURN_CHECK(APP_NAME, event.readFrom(&chain1));
+
+  // for information: the tool the acceptance executables use
+  OverlapRemovalTool orTool("OverlapRemovalTool");
+  CHECK(orTool.initialize());
+
+  DeltaRMatcher tau_matcher(cone);
+
+  typedef std::chrono::high_resolution_clock clock;
+  clock::duration t_p4(0);
+  clock::duration t_grid(0);
+  clock::duration t_tool(0);
+  unsigned long n_pairs = 0;
+  unsigned long n_removed_p4 = 0;
+  unsigned long n_removed_grid = 0;
+  unsigned long n_removed_tool = 0;
+  unsigned long n_mismatches_p4 = 0;
+  unsigned long n_mismatches_tool = 0;
+
+  std::vector<char> removed_p4;
+  std::vector<char> removed_grid;
+  std::vector<char> removed_tool;
+
+  Long64_t entries = event.getEntries();
+  for (Long64_t entry = 0; entry < entries; entry++) {
+     if ((entry%200)==0)
+       ::Info(APP_NAME, "Start processing event %d", (int)entry);
+
+    event.getEntry(entry);
+
+    const xAOD::TauJetContainer* taus = 0;
+    CHECK(event.retrieve(taus, "TauJets"));
+
+    const xAOD::JetContainer* jets = 0;
+    CHECK(event.retrieve(jets, "AntiKt4LCTopoJets"));
+
+    removed_p4.assign(jets->size(), 0);
+    removed_grid.assign(jets->size(), 0);
+    removed_tool.assign(jets->size(), 0);
+
+    // all the taus and jets take part in the removal
+    for (const auto tau: *taus)
+      selectDec(*tau) = true;
+    for (const auto jet: *jets)
+      selectDec(*jet) = true;
+
+    // the tool decorates the overlapping jets
+    clock::time_point start = clock::now();
+    for (int rep = 0; rep < repetitions; rep++) {
+      CHECK(orTool.removeTauJetOverlap(*taus, *jets));
+      for (unsigned int i = 0; i < jets->size(); i++)
+	removed_tool[i] = overlapAcc(*jets->at(i));
+    }
+    t_tool += clock::now() - start;
+
+    // reference: one DeltaR per tau - jet pair
+    start = clock::now();
+    for (int rep = 0; rep < repetitions; rep++) {
+      for (unsigned int i = 0; i < jets->size(); i++) {
+	const xAOD::Jet* jet = jets->at(i);
+	bool overlap = false;
+	for (const auto tau: *taus) {
+	  if (jet->p4().DeltaR(tau->p4()) < cone) {
+	    overlap = true;
+	    break;
+	  }
+	}
+	removed_p4[i] = overlap;
+      }
+    }
+    t_p4 += clock::now() - start;
+
+    // grid: the taus are indexed once per event
+    start = clock::now();
+    for (int rep = 0; rep < repetitions; rep++) {
+      tau_matcher.fill(*taus);
+      for (unsigned int i = 0; i < jets->size(); i++)
+	removed_grid[i] = tau_matcher.match(jets->at(i));
+    }
+    t_grid += clock::now() - start;
+
+    n_pairs += taus->size() * jets->size();
+    for (unsigned int i = 0; i < jets->size(); i++) {
+      n_removed_p4 += removed_p4[i];
+      n_removed_grid += removed_grid[i];
+      n_removed_tool += removed_tool[i];
+      if (removed_p4[i] != removed_grid[i])
+	n_mismatches_p4++;
+      if (removed_tool[i] != removed_grid[i])
+	n_mismatches_tool++;
+    }
+  }
+
+  const double ms_p4 = std::chrono::duration<double, std::milli>(t_p4).count();
+  const double ms_grid = std::chrono::duration<double, std::milli>(t_grid).count();
+  const double ms_tool = std::chrono::duration<double, std::milli>(t_tool).count();
+
+  ::Info(APP_NAME, "%lld events, %lu tau - jet pairs, cone = %.2f, %d repetitions", entries, n_pairs, cone, repetitions);
+  ::Info(APP_NAME, "removeTauJetOverlap:    %.1f ms, %lu jets removed", ms_tool, n_removed_tool);
+  ::Info(APP_NAME, "TLorentzVector::DeltaR: %.1f ms, %lu jets removed", ms_p4, n_removed_p4);
+  ::Info(APP_NAME, "DeltaRMatcher:          %.1f ms, %lu jets removed", ms_grid, n_removed_grid);
+  ::Info(APP_NAME, "DeltaRMatcher vs TLorentzVector::DeltaR: speed up = %.2f, %lu jets with a different decision",
+	 ms_grid > 0 ? ms_p4 / ms_grid : 0., n_mismatches_p4);
+  ::Info(APP_NAME, "DeltaRMatcher vs removeTauJetOverlap (information only): speed up = %.2f, %lu jets with a different decision",
+	 ms_grid > 0 ? ms_tool / ms_grid : 0., n_mismatches_tool);
+
+  // the grid stands in for the per-pair DeltaR: they have to agree on every jet
+  return n_mismatches_p4 == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// Dear emacs, this is -*- c++ -*-
+// vim: ts=2 sw=2
+// $Id$
+
+// Confusion matrices, pairwise overlaps and unique rates of the L1 items
+// from the bit-packed decisions written by L1EmulationLoop
+// (validator l1 --write-decisions, data-l1_decisions in the run directory).
+// usage: decision_matrix file [output]
+
+// System include(s):
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROOT include(s):
+#include <TError.h>
+#include <TFile.h>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TTree.h>
+
+// Local stuff
+#include "TriggerValidation/DecisionBits.h"
+
+
+// indices of the set bits
+void setBits(const std::vector<ULong64_t>& bits, std::vector<unsigned int>& indices) {
+  indices.clear();
+  for (unsigned int w = 0; w < bits.size(); w++) {
+    for (ULong64_t word = bits[w]; word; word &= word - 1)
+      indices.push_back(w * 64 + __builtin_ctzll(word));
+  }
+}
+
+unsigned int popcount(const std::vector<ULong64_t>& bits) {
+  unsigned int n = 0;
+  for (auto word : bits)
+    n += __builtin_popcountll(word);
+  return n;
+}
+
+TH2F* overlapHist(const char* name, const std::vector<std::string>& chains, const std::vector<unsigned long>& overlaps) {
+  const unsigned int n = chains.size();
+  TH2F* h = new TH2F(name, name, n, 0, n, n, 0, n);
+  for (unsigned int i = 0; i < n; i++) {
+    h->GetXaxis()->SetBinLabel(i + 1, chains[i].c_str());
+    h->GetYaxis()->SetBinLabel(i + 1, chains[i].c_str());
+    for (unsigned int j = 0; j < n; j++)
+      h->SetBinContent(i + 1, j + 1, overlaps[i * n + j]);
+  }
+  return h;
+}
+
+
+int main(int argc, char **argv) {
+
+  // Get the name of the application:
+  const char* APP_NAME = "decision_matrix";
+
+  if (argc < 2) {
+    ::Error(APP_NAME, "usage: %s file [output]", APP_NAME);
+    return 1;
+  }
+
+  std::string output = "decision_matrix.root";
+  if (argc > 2)
+    output = argv[2];
+
+  std::unique_ptr<TFile> file(TFile::Open(argv[1]));
+  if (not file or file->IsZombie()) {
+    ::Error(APP_NAME, "Cannot open %s", argv[1]);
+    return 1;
+  }
+
+  TTree* tree = 0;
+  file->GetObject("decisions", tree);
+  DecisionBits decisions;
+  if (not tree or not decisions.attach(tree)) {
+    ::Error(APP_NAME, "No decisions tree in %s", argv[1]);
+    return 1;
+  }
+
+  const std::vector<std::string>& chains = decisions.chains();
+  const unsigned int n = chains.size();
+
+  // per item: both fire, only the TDT fires, only the emulation fires
+  std::vector<unsigned long> both(n, 0), tdt_only(n, 0), emu_only(n, 0);
+  // per item: the only item firing in the event
+  std::vector<unsigned long> unique_tdt(n, 0), unique_emu(n, 0);
+  // per pair of items, both firing
+  std::vector<unsigned long> overlap_tdt(n * n, 0), overlap_emu(n * n, 0);
+  unsigned long union_tdt = 0, union_emu = 0;
+
+  std::vector<ULong64_t> bits(decisions.words());
+  std::vector<unsigned int> fired;
+
+  const Long64_t entries = tree->GetEntries();
+  for (Long64_t entry = 0; entry < entries; entry++) {
+    tree->GetEntry(entry);
+    const std::vector<ULong64_t>& tdt = decisions.m_tdt;
+    const std::vector<ULong64_t>& emu = decisions.m_emulation;
+
+    for (unsigned int w = 0; w < bits.size(); w++)
+      bits[w] = tdt[w] & emu[w];
+    setBits(bits, fired);
+    for (auto i : fired)
+      both[i]++;
+
+    for (unsigned int w = 0; w < bits.size(); w++)
+      bits[w] = tdt[w] & ~emu[w];
+    setBits(bits, fired);
+    for (auto i : fired)
+      tdt_only[i]++;
+
+    for (unsigned int w = 0; w < bits.size(); w++)
+      bits[w] = ~tdt[w] & emu[w];
+    setBits(bits, fired);
+    for (auto i : fired)
+      emu_only[i]++;
+
+    // rates over the items
+    const unsigned int n_tdt = popcount(tdt);
+    const unsigned int n_emu = popcount(emu);
+    union_tdt += n_tdt > 0;
+    union_emu += n_emu > 0;
+
+    setBits(tdt, fired);
+    if (n_tdt == 1)
+      unique_tdt[fired[0]]++;
+    for (auto i : fired)
+      for (auto j : fired)
+	overlap_tdt[i * n + j]++;
+
+    setBits(emu, fired);
+    if (n_emu == 1)
+      unique_emu[fired[0]]++;
+    for (auto i : fired)
+      for (auto j : fired)
+	overlap_emu[i * n + j]++;
+  }
+
+  printf("%lld events, %lu fired by the TDT, %lu by the emulation\n", entries, union_tdt, union_emu);
+  printf("%43s | %8s | %8s | %8s | %8s | %8s | %10s | %10s\n", "Item", "TDT", "EMU", "both", "TDT only", "EMU only",
+	 "unique TDT", "unique EMU");
+  for (unsigned int i = 0; i < n; i++) {
+    printf("%43s | %8lu | %8lu | %8lu | %8lu | %8lu | %10lu | %10lu\n", chains[i].c_str(), both[i] + tdt_only[i],
+	   both[i] + emu_only[i], both[i], tdt_only[i], emu_only[i], unique_tdt[i], unique_emu[i]);
+  }
+
+  TFile fout(output.c_str(), "RECREATE");
+
+  // per item: both, TDT only, emulation only, neither
+  TH2F* h_confusion = new TH2F("h_confusion", "confusion", n, 0, n, 4, 0, 4);
+  h_confusion->GetYaxis()->SetBinLabel(1, "both");
+  h_confusion->GetYaxis()->SetBinLabel(2, "TDT_only");
+  h_confusion->GetYaxis()->SetBinLabel(3, "EMU_only");
+  h_confusion->GetYaxis()->SetBinLabel(4, "neither");
+
+  TH1F* h_unique_tdt = new TH1F("h_unique_TDT", "unique_TDT", n, 0, n);
+  TH1F* h_unique_emu = new TH1F("h_unique_EMU", "unique_EMU", n, 0, n);
+  for (unsigned int i = 0; i < n; i++) {
+    h_confusion->GetXaxis()->SetBinLabel(i + 1, chains[i].c_str());
+    h_confusion->SetBinContent(i + 1, 1, both[i]);
+    h_confusion->SetBinContent(i + 1, 2, tdt_only[i]);
+    h_confusion->SetBinContent(i + 1, 3, emu_only[i]);
+    h_confusion->SetBinContent(i + 1, 4, entries - both[i] - tdt_only[i] - emu_only[i]);
+
+    h_unique_tdt->GetXaxis()->SetBinLabel(i + 1, chains[i].c_str());
+    h_unique_emu->GetXaxis()->SetBinLabel(i + 1, chains[i].c_str());
+    h_unique_tdt->SetBinContent(i + 1, unique_tdt[i]);
+    h_unique_emu->SetBinContent(i + 1, unique_emu[i]);
+  }
+
+  overlapHist("h_overlap_TDT", chains, overlap_tdt);
+  overlapHist("h_overlap_EMU", chains, overlap_emu);
+
+  fout.Write();
+  fout.Close();
+  ::Info(APP_NAME, "Histograms written to %s", output.c_str());
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+// Dear emacs, this is -*- c++ -*-
+// vim: ts=2 sw=2
+// $Id$
+
+// Print the TDT - emulation disagreements recorded by L1EmulationLoop and
+// HLTEmulationLoop (data-l1_mismatches / data-hlt_mismatches in the run
+// directory).
+// usage: read_mismatches file [chain] [event]
+// only the records of chains containing 'chain' are printed, and only the
+// event 'event' if given.
+
+// System include(s):
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+// ROOT include(s):
+#include <TError.h>
+#include <TFile.h>
+#include <TTree.h>
+
+// Local stuff
+#include "TriggerValidation/MismatchRecorder.h"
+
+
+int main(int argc, char **argv) {
+
+  // Get the name of the application:
+  const char* APP_NAME = "read_mismatches";
+
+  if (argc < 2) {
+    ::Error(APP_NAME, "usage: %s file [chain] [event]", APP_NAME);
+    return 1;
+  }
+
+  std::string chain_filter = "";
+  if (argc > 2)
+    chain_filter = argv[2];
+
+  bool select_event = false;
+  unsigned long long selected_event = 0;
+  if (argc > 3) {
+    select_event = true;
+    selected_event = strtoull(argv[3], 0, 10);
+  }
+
+  std::unique_ptr<TFile> file(TFile::Open(argv[1]));
+  if (not file or file->IsZombie()) {
+    ::Error(APP_NAME, "Cannot open %s", argv[1]);
+    return 1;
+  }
+
+  TTree* tree = 0;
+  file->GetObject("mismatches", tree);
+  MismatchRecorder records;
+  if (not tree or not records.attach(tree)) {
+    ::Error(APP_NAME, "No mismatches tree in %s", argv[1]);
+    return 1;
+  }
+
+  const auto& chains = records.chains();
+  Long64_t n_printed = 0;
+  for (Long64_t entry = 0; entry < tree->GetEntries(); entry++) {
+    tree->GetEntry(entry);
+    if (select_event and records.m_event != selected_event)
+      continue;
+
+    bool header = false;
+    for (unsigned int i = 0; i < records.m_chain.size(); i++) {
+      const unsigned int ich = records.m_chain[i];
+      const std::string name = ich < chains.size() ? chains[ich] : std::to_string(ich);
+      if (name.find(chain_filter) == std::string::npos)
+	continue;
+
+      if (not header) {
+	printf("run %u -- event %llu -- lumi block %u\n", records.m_run, records.m_event, records.m_lumiblock);
+	printf("\t %43s |  TDT  | EMULATION\n", "Chain");
+	header = true;
+      }
+      printf("\t %43s |  %5d| %9d\n", name.c_str(), (int)records.m_tdt[i], (int)records.m_emulation[i]);
+    }
+    if (not header)
+      continue;
+
+    for (unsigned int i = 0; i < records.m_kind.size(); i++) {
+      printf("\t %-18s pt = %10.1f  eta = %6.2f  phi = %6.2f\n",
+	     MismatchRecorder::kindName((MismatchRecorder::Kind)records.m_kind[i]),
+	     records.m_pt[i], records.m_eta[i], records.m_phi[i]);
+    }
+    n_printed++;
+  }
+
+  ::Info(APP_NAME, "%lld / %lld recorded events printed", n_printed, tree->GetEntries());
+  return 0;
+}